@@ -37,6 +37,8 @@ class Colored_piece {
 		return !((piece != NO_PIECE) xor (color != NO_COLOR));
 	}
 
+	// symbol of the piece in UTF-8, to print without allocating
+	const char* to_utf_cstr() const;
 	std::string to_utf() const;
 	std::string to_string() const;
 };
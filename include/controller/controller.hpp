@@ -2,7 +2,10 @@
 
 #include <memory>
 
+#include "controller/game_task.hpp"
 #include "logic/chessboard.hpp"
+#include "notation/pgn_writer.hpp"
+#include "player/async_player.hpp"
 #include "player/player.hpp"
 #include "view/noop_view.hpp"
 
@@ -12,10 +15,17 @@
  */
 class Controller {
        private:
-	std::unique_ptr<Player> white;
-	std::unique_ptr<Player> black;
+	std::unique_ptr<Async_player> white;
+	std::unique_ptr<Async_player> black;
 	std::unique_ptr<View> view;
 	Chessboard chessboard;
+	notation::Pgn_writer *recorder = nullptr;
+	int turn                       = 0;
+	bool is_invalid                = false;
+
+	void begin();
+	bool apply(const Player_move &player_move);
+	void finish();
 
        public:
 	/**
@@ -29,8 +39,8 @@ class Controller {
 	Controller(std::unique_ptr<Player> white, std::unique_ptr<Player> black,
 		   std::unique_ptr<View> view,
 		   board::Board board = board::initial_board)
-	    : white(std::move(white)),
-	      black(std::move(black)),
+	    : white(std::make_unique<Player_adapter>(std::move(white))),
+	      black(std::make_unique<Player_adapter>(std::move(black))),
 	      view(std::move(view)),
 	      chessboard(board){};
 	/**
@@ -43,14 +53,68 @@ class Controller {
 	 */
 	Controller(std::unique_ptr<Player> white, std::unique_ptr<Player> black,
 		   board::Board board = board::initial_board)
+	    : white(std::make_unique<Player_adapter>(std::move(white))),
+	      black(std::make_unique<Player_adapter>(std::move(black))),
+	      view(std::make_unique<View_noop>()),
+	      chessboard(board){};
+	/**
+	 * @brief Construct a new Controller object continuing a game without a
+	 * view to render it
+	 *
+	 * @param white Player that control white
+	 * @param black Player that control black
+	 * @param chessboard Position to start from, either side can be to move
+	 */
+	Controller(std::unique_ptr<Player> white, std::unique_ptr<Player> black,
+		   const Chessboard &chessboard)
+	    : white(std::make_unique<Player_adapter>(std::move(white))),
+	      black(std::make_unique<Player_adapter>(std::move(black))),
+	      view(std::make_unique<View_noop>()),
+	      chessboard(chessboard){};
+	/**
+	 * @brief Construct a new Controller object between asynchronous
+	 * players, without a view to render the game
+	 *
+	 * @param white Player that control white
+	 * @param black Player that control black
+	 * @param chessboard Position to start from, either side can be to move
+	 */
+	Controller(std::unique_ptr<Async_player> white,
+		   std::unique_ptr<Async_player> black,
+		   const Chessboard &chessboard = Chessboard())
 	    : white(std::move(white)),
 	      black(std::move(black)),
 	      view(std::make_unique<View_noop>()),
-	      chessboard(board){};
+	      chessboard(chessboard){};
+
+	/**
+	 * @brief Record the games in PGN
+	 *
+	 * @param recorder Writer of the games, it must outlive the controller,
+	 * nullptr to stop recording
+	 */
+	void set_recorder(notation::Pgn_writer *recorder) {
+		this->recorder = recorder;
+	};
 
 	/**
-	 * @brief Start the game
+	 * @brief Get the current position of the game
+	 *
+	 * @return const Chessboard&
+	 */
+	const Chessboard &get_chessboard() const { return chessboard; };
+
+	/**
+	 * @brief Play the whole game on the calling thread, waiting for the
+	 * answers of asynchronous players without busy waiting
 	 *
 	 */
 	void start();
+	/**
+	 * @brief Coroutine playing the game, it yields to the other games of
+	 * its executor after each move
+	 *
+	 * @return Game_task Suspended coroutine, to start on an executor
+	 */
+	Game_task play();
 };
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "controller/controller.hpp"
+#include "controller/game_task.hpp"
+#include "utils/executor.hpp"
+#include "utils/thread_pool.hpp"
+
+/**
+ * @brief Counters of a Game_scheduler
+ */
+struct Scheduler_stats {
+	// games queued or being played
+	size_t running;
+	// games waiting for the answer of a player
+	size_t waiting;
+	size_t finished;
+	// games ready to go on, waiting for a worker
+	size_t queue_depth;
+	size_t max_queue_depth;
+	// times a game was resumed
+	uint64_t steps;
+	// time between a game becoming ready and a worker resuming it
+	double mean_latency_ms;
+	double max_latency_ms;
+	// duration of the finished games
+	double mean_game_ms;
+};
+
+/**
+ * @brief Host many games on a fixed pool of workers. Each game is a coroutine
+ * that goes back to the end of the queue after each move, so the games take
+ * turns on the workers. A game waiting for the answer of a player is
+ * suspended without holding a worker, the answer queues it again.
+ */
+class Game_scheduler : public Executor {
+	using Clock = std::chrono::steady_clock;
+
+	struct Game {
+		std::unique_ptr<Controller> controller;
+		Game_task task;
+		Clock::time_point started;
+	};
+
+	std::mutex mutex;
+	std::condition_variable all_finished;
+	std::unordered_map<size_t, Game> games;
+	std::function<void(size_t, const Controller &)> on_finished;
+	std::exception_ptr error;
+	size_t next_id = 0;
+
+	size_t executing       = 0;
+	size_t finished        = 0;
+	size_t queue_depth     = 0;
+	size_t max_queue_depth = 0;
+	uint64_t steps         = 0;
+	Clock::duration total_latency{0};
+	Clock::duration max_latency{0};
+	Clock::duration total_game{0};
+
+	// last member, the workers stop before the games are destroyed
+	Thread_pool pool;
+
+	void finish(size_t id);
+
+       public:
+	/**
+	 * @brief Start the workers
+	 *
+	 * @param threads Number of workers, one per core by default
+	 */
+	explicit Game_scheduler(size_t threads = Thread_pool::default_size())
+	    : pool(threads){};
+	Game_scheduler(const Game_scheduler &)            = delete;
+	Game_scheduler(Game_scheduler &&)                 = delete;
+	Game_scheduler &operator=(const Game_scheduler &) = delete;
+	Game_scheduler &operator=(Game_scheduler &&)      = delete;
+	~Game_scheduler() override                        = default;
+
+	/**
+	 * @brief Queue a game to resume on a worker
+	 *
+	 * @param coroutine Suspended game
+	 */
+	void post(std::coroutine_handle<> coroutine) override;
+
+	/**
+	 * @brief Start a game
+	 *
+	 * @param controller Game to play
+	 * @return size_t Identifier of the game
+	 */
+	size_t add(std::unique_ptr<Controller> controller);
+	/**
+	 * @brief Set the function called by a worker when a game ends, before
+	 * the game is destroyed. The scheduler is locked during the call, the
+	 * function must not use it.
+	 *
+	 * @param on_finished Function taking the identifier and the game
+	 */
+	void set_on_finished(
+	    std::function<void(size_t, const Controller &)> on_finished) {
+		this->on_finished = std::move(on_finished);
+	};
+	/**
+	 * @brief Block until every game is over, rethrow the first exception
+	 * thrown by a game if any
+	 */
+	void wait();
+	/**
+	 * @brief Get the counters
+	 *
+	 * @return Scheduler_stats
+	 */
+	Scheduler_stats get_stats();
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#include "utils/executor.hpp"
+
+/**
+ * @brief Coroutine playing a game. It starts suspended and runs on the
+ * executor given to start(), the futures it awaits resume it there.
+ */
+class Game_task {
+       public:
+	struct promise_type;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	struct promise_type {
+		Executor *executor = nullptr;
+		std::function<void()> on_done;
+		std::exception_ptr error;
+
+		// tell the owner once the coroutine can be destroyed
+		struct Final_awaiter {
+			bool await_ready() noexcept { return false; };
+			void await_suspend(Handle coroutine) noexcept {
+				// on_done may destroy the coroutine, keep it
+				// out of the frame
+				std::function<void()> on_done =
+				    std::move(coroutine.promise().on_done);
+				if (on_done) on_done();
+			};
+			void await_resume() noexcept {};
+		};
+
+		Game_task get_return_object() {
+			return Game_task(Handle::from_promise(*this));
+		};
+		std::suspend_always initial_suspend() noexcept { return {}; };
+		Final_awaiter final_suspend() noexcept { return {}; };
+		void return_void(){};
+		void unhandled_exception() {
+			error = std::current_exception();
+		};
+	};
+
+       private:
+	Handle coroutine;
+
+       public:
+	explicit Game_task(Handle coroutine) : coroutine(coroutine){};
+	Game_task(Game_task &&other)
+	    : coroutine(std::exchange(other.coroutine, nullptr)){};
+	Game_task(const Game_task &)            = delete;
+	Game_task &operator=(const Game_task &) = delete;
+	Game_task &operator=(Game_task &&)      = delete;
+	~Game_task() {
+		if (coroutine) coroutine.destroy();
+	};
+
+	/**
+	 * @brief Queue the coroutine on an executor
+	 *
+	 * @param executor Executor running the whole game
+	 * @param on_done Function called by the executor when the game is
+	 * over, the task can be destroyed from it
+	 */
+	void start(Executor &executor, std::function<void()> on_done = {}) {
+		coroutine.promise().executor = &executor;
+		coroutine.promise().on_done  = std::move(on_done);
+		executor.post(coroutine);
+	};
+	/**
+	 * @brief Check if the game is over
+	 *
+	 * @return bool
+	 */
+	bool is_done() const { return coroutine.done(); };
+	/**
+	 * @brief Rethrow the exception that ended the game if any
+	 */
+	void get() const {
+		if (coroutine.promise().error) {
+			std::rethrow_exception(coroutine.promise().error);
+		}
+	};
+};
+
+/**
+ * @brief Awaitable putting the coroutine back at the end of the queue of its
+ * executor, so the other games get their turn
+ */
+struct Yield {
+	bool await_ready() const { return false; };
+	template <typename Promise>
+	void await_suspend(std::coroutine_handle<Promise> coroutine) const {
+		coroutine.promise().executor->post(coroutine);
+	}
+	void await_resume() const {};
+};
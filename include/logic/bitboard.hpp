@@ -4,11 +4,12 @@
 
 #include "utils.hpp"
 
-#define BOARD_CLEAR (Bitboard)0x0000000000000000
-#define BBLINE_1    (Bitboard)0x00000000000000FF
-#define BBROW_A     (Bitboard)0x0101010101010101
-#define DIAG_A18H   (Bitboard)0x8040201008040201
-#define DIAG_H1A8   (Bitboard)0x0102040810204080
+#define BOARD_CLEAR   (Bitboard)0x0000000000000000
+#define BBLINE_1      (Bitboard)0x00000000000000FF
+#define BBROW_A       (Bitboard)0x0101010101010101
+#define DIAG_A18H     (Bitboard)0x8040201008040201
+#define DIAG_H1A8     (Bitboard)0x0102040810204080
+#define LIGHT_SQUARES (Bitboard)0x55AA55AA55AA55AA
 
 namespace logic {
 
@@ -91,6 +92,38 @@ constexpr Direction opposite(Direction d) {
 	return (d % 2 == 0 ? Direction(d + 1) : Direction(d - 1));
 }
 
+/**
+ * @brief Move every square of a bitboard one step in a direction, squares
+ * leaving the board are dropped
+ */
+template <Direction d>
+constexpr Bitboard shift(Bitboard bitboard) {
+	switch (d) {
+	case NORTH:
+		return bitboard << 8;
+	case SOUTH:
+		return bitboard >> 8;
+	case EAST:
+		return (bitboard & ~bb_of(COL_H)) << 1;
+	case WEST:
+		return (bitboard & ~bb_of(COL_A)) >> 1;
+	case NORTH_WEST:
+		return (bitboard & ~bb_of(COL_A)) << 7;
+	case SOUTH_EAST:
+		return (bitboard & ~bb_of(COL_H)) >> 7;
+	case NORTH_EAST:
+		return (bitboard & ~bb_of(COL_H)) << 9;
+	case SOUTH_WEST:
+		return (bitboard & ~bb_of(COL_A)) >> 9;
+	}
+}
+
+// offset of the square reached by one step in a direction
+constexpr int step(Direction d) {
+	constexpr int steps[] = {8, -8, 1, -1, 7, -7, 9, -9};
+	return steps[d];
+}
+
 template <Column r>
 constexpr bool is_on_col(Square square) {
 	return square % 8 == r;
@@ -116,6 +149,106 @@ constexpr Bitboard bounded_bb_of(Column col) {
 constexpr Column col_of(Square square) { return Column(square % 8); }
 constexpr Line line_of(Square square) { return Line(square / 8); }
 
+// Tables {{{
+// line and column steps of each direction
+constexpr int line_step[] = {1, -1, 0, 0, 1, -1, 1, -1};
+constexpr int col_step[]  = {0, 0, 1, -1, -1, 1, 1, -1};
+
+constexpr Bitboard bb_of(int line, int col) {
+	if (line < LINE_1 || LINE_8 < line || col < COL_A || COL_H < col) {
+		return BOARD_CLEAR;
+	}
+	return bb_of(Square(line * 8 + col));
+}
+
+struct Tables {
+	// from the square, included, to the edge of the board
+	Bitboard ray[DIRECTION_NB][SQUARE_NB];
+	// squares strictly between two aligned squares, empty otherwise
+	Bitboard between[SQUARE_NB][SQUARE_NB];
+	// whole line through two aligned squares, empty otherwise
+	Bitboard line[SQUARE_NB][SQUARE_NB];
+	// slider attacks on an empty board
+	Bitboard rook[SQUARE_NB];
+	Bitboard bishop[SQUARE_NB];
+	Bitboard knight[SQUARE_NB];
+	Bitboard king[SQUARE_NB];
+	// indexed by the color of the pawn, white first
+	Bitboard pawn[2][SQUARE_NB];
+};
+
+constexpr Tables generate_tables() {
+	Tables tables{};
+	for (int square = SQ_A1; square <= SQ_H8; square++) {
+		const int line = square / 8;
+		const int col  = square % 8;
+		for (int d = NORTH; d < DIRECTION_NB; d++) {
+			Bitboard ray = bb_of(Square(square));
+			for (int i = 1;; i++) {
+				const int to_line   = line + i * line_step[d];
+				const int to_col    = col + i * col_step[d];
+				const Bitboard next = bb_of(to_line, to_col);
+				if (!next) break;
+				const Square to = Square(lsb(next));
+				tables.between[square][to] =
+				    ray & ~bb_of(Square(square));
+				ray |= next;
+			}
+			tables.ray[d][square] = ray;
+			if (line_step[d] == 0 || col_step[d] == 0) {
+				tables.rook[square] |= ray;
+			} else {
+				tables.bishop[square] |= ray;
+			}
+		}
+		tables.rook[square] &= ~bb_of(Square(square));
+		tables.bishop[square] &= ~bb_of(Square(square));
+		for (int d = NORTH; d < DIRECTION_NB; d++) {
+			const Bitboard line_bb = tables.ray[d][square] |
+						 tables.ray[d ^ 1][square];
+			Bitboard aligned = tables.ray[d][square];
+			aligned &= ~bb_of(Square(square));
+			while (aligned) {
+				const int to = lsb(aligned);
+				aligned &= aligned - 1;
+				tables.line[square][to] = line_bb;
+			}
+		}
+		for (int l = -2; l <= 2; l++) {
+			for (int c = -2; c <= 2; c++) {
+				if (l * l + c * c == 5) {
+					tables.knight[square] |=
+					    bb_of(line + l, col + c);
+				}
+				if (l * l + c * c == 1 || l * l + c * c == 2) {
+					tables.king[square] |=
+					    bb_of(line + l, col + c);
+				}
+			}
+		}
+		tables.pawn[0][square] =
+		    bb_of(line + 1, col - 1) | bb_of(line + 1, col + 1);
+		tables.pawn[1][square] =
+		    bb_of(line - 1, col - 1) | bb_of(line - 1, col + 1);
+	}
+	return tables;
+}
+
+/**
+ * @brief Precomputed attack and geometry tables, built at compile time
+ */
+inline constexpr Tables tables = generate_tables();
+
+inline constexpr auto &RAY            = tables.ray;
+inline constexpr auto &BETWEEN        = tables.between;
+inline constexpr auto &LINE           = tables.line;
+inline constexpr auto &ROOK_RAYS      = tables.rook;
+inline constexpr auto &BISHOP_RAYS    = tables.bishop;
+inline constexpr auto &KNIGHT_ATTACKS = tables.knight;
+inline constexpr auto &KING_ATTACKS   = tables.king;
+inline constexpr auto &PAWN_ATTACKS   = tables.pawn;
+/*}}}*/
+
 template <Direction d>
 constexpr Square collision(Bitboard ray, Bitboard obstacles) {
 	if (d % 2 == 0) {
@@ -127,32 +260,7 @@ constexpr Square collision(Bitboard ray, Bitboard obstacles) {
 
 template <Direction d>
 constexpr Bitboard ray(Square from) {
-	switch (d) {
-	case NORTH:
-		return BBROW_A << (col_of(from) + 8 * line_of(from));
-	case SOUTH:
-		return (BBROW_A << col_of(from)) >> 8 * (7 - line_of(from));
-	case EAST:
-		return BBLINE_1 >> col_of(from)
-				       << (col_of(from) + 8 * line_of(from));
-	case WEST:
-		return BBLINE_1 >> (7 - col_of(from)) << 8 * line_of(from);
-	case NORTH_WEST:
-		return DIAG_H1A8 << 8 * (7 - col_of(from)) >>
-		       8 * (7 - col_of(from)) >>
-		       (7 - col_of(from)) << 8 * line_of(from);
-	case SOUTH_EAST:
-		return DIAG_H1A8 >>
-		       8 * col_of(from) << 8 * col_of(from) << col_of(from) >>
-		       8 * (7 - line_of(from));
-	case NORTH_EAST:
-		return DIAG_A18H << 9 * col_of(from) >>
-		       8 * col_of(from) << 8 * line_of(from);
-	case SOUTH_WEST:
-		return DIAG_A18H >>
-		       9 * (7 - col_of(from)) << 8 * (7 - col_of(from)) >>
-		       8 * (7 - line_of(from));
-	}
+	return RAY[d][from];
 }
 
 template <Direction d>
@@ -167,4 +275,30 @@ constexpr Bitboard ray_between(Square square, Bitboard obstacles) {
 	    ray<opposite(d)>(collision<d>(forward, obstacles));
 	return forward & backward;
 }
+
+// Slider attacks {{{
+/**
+ * @brief Squares attacked along a direction, up to and including the first
+ * obstacle
+ */
+template <Direction d>
+constexpr Bitboard ray_attack(Square square, Bitboard obstacles) {
+	const Bitboard origin = bb_of(square);
+	return ray_between<d>(square, obstacles & ~origin) & ~origin;
+}
+
+constexpr Bitboard rook_attacks(Square square, Bitboard obstacles) {
+	return ray_attack<NORTH>(square, obstacles) |
+	       ray_attack<SOUTH>(square, obstacles) |
+	       ray_attack<EAST>(square, obstacles) |
+	       ray_attack<WEST>(square, obstacles);
+}
+
+constexpr Bitboard bishop_attacks(Square square, Bitboard obstacles) {
+	return ray_attack<NORTH_EAST>(square, obstacles) |
+	       ray_attack<NORTH_WEST>(square, obstacles) |
+	       ray_attack<SOUTH_EAST>(square, obstacles) |
+	       ray_attack<SOUTH_WEST>(square, obstacles);
+}
+/*}}}*/
 }  // namespace logic
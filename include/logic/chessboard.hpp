@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 #include "board.hpp"
 #include "logic/bitboard.hpp"
+#include "logic/key_history.hpp"
+#include "logic/move_cache.hpp"
+#include "logic/position.hpp"
 
 namespace logic {
 enum Side {
@@ -45,22 +50,50 @@ enum GameState {
 	WHITE_CHECKMATE,
 	BLACK_CHECKMATE,
 	STALEMATE,
+	// third occurrence of the same position
+	REPETITION,
+	// 50 moves of each side without a capture or a pawn move
+	FIFTY_MOVES,
+	// no sequence of moves can lead to a checkmate
+	INSUFFICIENT_MATERIAL,
 };
 
+/**
+ * @brief Score of a game as written at the end of a PGN movetext
+ *
+ * @param state GameState
+ * @return "1-0", "0-1", "1/2-1/2" or "?-?" while the game is ongoing
+ */
+std::string_view to_string(GameState state);
+
 // class Chessboard {{{
 class Chessboard {
 	logic::Bitboard color[2];
 	logic::Bitboard pieces[6];
 	logic::Bitboard attacks;
-	logic::Bitboard threat;
+	// attacks of the piece on each square, only the ones affected by a
+	// move are recomputed
+	logic::Bitboard piece_attacks[64];
+	logic::Bitboard checkers;
+	logic::Bitboard pinned;
 	logic::Bitboard legal_moves[64];
+	// piece and color of each square, kept in sync with the bitboards
+	uint8_t mailbox[64];
 	logic::Square enpassant;
+	// Zobrist key, updated along with the mailbox
+	uint64_t key;
 	unsigned int turn_count;
+	// plies since the last capture or pawn move
+	unsigned int halfmove_clock;
+	logic::Key_history history;
 	unsigned int legal_move_count;
-	unsigned int check_count;
 	logic::Castling castling;
 	GameState game_state = ONGOING;
 	board::Move last_move;
+	// piece taken by the last move
+	board::Colored_piece last_capture;
+	// shared by the copies, not owned
+	logic::Move_cache* cache = nullptr;
 
        public:
 	/**
@@ -69,6 +102,14 @@ class Chessboard {
 	 * @param board Initial board
 	 */
 	Chessboard(const board::Board& board = board::initial_board);
+	/**
+	 * @brief Constructor from a compact position
+	 *
+	 * @param position Position to continue from, its key is recomputed
+	 * @throw std::invalid_argument if each side doesn't have exactly one
+	 * king
+	 */
+	explicit Chessboard(const logic::Position& position);
 
 	/**
 	 * @brief Check if a move is legal and update the chessboard according
@@ -101,6 +142,12 @@ class Chessboard {
 	 * @return int
 	 */
 	int get_turn_count() const { return turn_count; };
+	/**
+	 * @brief Get the number of plies since the last capture or pawn move
+	 *
+	 * @return unsigned int
+	 */
+	unsigned int get_halfmove_clock() const { return halfmove_clock; };
 	/**
 	 * @brief Get the piece on the square
 	 *
@@ -108,6 +155,80 @@ class Chessboard {
 	 * @return board::Colored_piece
 	 */
 	board::Colored_piece get_piece(board::Square square) const;
+	/**
+	 * @brief Get the Zobrist key of the position, equal for two positions
+	 * that are the same
+	 *
+	 * @return uint64_t
+	 */
+	uint64_t get_key() const { return key; };
+	/**
+	 * @brief Copy the current position in its compact form
+	 *
+	 * @return logic::Position
+	 */
+	logic::Position get_position() const;
+	/**
+	 * @brief Reuse the move sets of the positions already met, the copies
+	 * of the chessboard share the cache
+	 *
+	 * @param cache Cache to use from the next move, nullptr to stop using
+	 * one. It must outlive the chessboard and its copies, and can't be
+	 * shared between threads.
+	 */
+	void set_cache(logic::Move_cache* cache) { this->cache = cache; };
+	/**
+	 * @brief Check if the player to move is in check
+	 *
+	 * @return true if the king of the player to move is attacked
+	 */
+	bool is_check() const { return checkers; };
+	/**
+	 * @brief Get the enemy pieces giving check to the player to move
+	 *
+	 * @return logic::Bitboard
+	 */
+	logic::Bitboard get_checkers() const { return checkers; };
+	/**
+	 * @brief Get the pieces of the player to move pinned to their king
+	 *
+	 * @return logic::Bitboard
+	 */
+	logic::Bitboard get_pinned() const { return pinned; };
+	/**
+	 * @brief Get the color of the player to move
+	 *
+	 * @return logic::Color
+	 */
+	logic::Color get_turn() const { return logic::Color(turn_count % 2); };
+	/**
+	 * @brief Get the bitboard of the pieces of a given type and color
+	 *
+	 * @param piece Type of the pieces
+	 * @param c Color of the pieces
+	 * @return logic::Bitboard
+	 */
+	logic::Bitboard get_pieces(logic::Piece piece, logic::Color c) const {
+		return pieces[piece] & color[c];
+	};
+	/**
+	 * @brief Get the legal destinations of the piece on a square in
+	 * constant time
+	 *
+	 * @param square Origin square
+	 * @return logic::Bitboard
+	 */
+	logic::Bitboard get_legal_moves(logic::Square square) const {
+		return legal_moves[square];
+	};
+	/**
+	 * @brief Check if a move gives check without making it
+	 *
+	 * @param move Legal move of the player to move
+	 * @return true if the move attacks the enemy king, directly or by
+	 * discovery
+	 */
+	bool gives_check(board::Move move) const;
 
 	/**
 	 * @brief Get the current state of the game
@@ -140,6 +261,13 @@ class Chessboard {
 	 * @return board::Move
 	 */
 	board::Move get_last_move() const { return last_move; };
+	/**
+	 * @brief Return the piece taken by the last move, the pawn taken en
+	 * passant included
+	 *
+	 * @return board::Colored_piece board::xx if nothing was taken
+	 */
+	board::Colored_piece get_last_capture() const { return last_capture; };
 
 	/**
 	 * @brief Create a board::Board from the current state of the chessboard
@@ -150,6 +278,9 @@ class Chessboard {
 
        private:
 	// --- Utils ---
+	uint64_t compute_key() const;
+	logic::Castling initial_castling() const;
+	bool is_insufficient_material() const;
 	bool is_attacked(board::Square square) const;
 	template <logic::Color c>
 	bool can_castle() const;
@@ -157,39 +288,24 @@ class Chessboard {
 	bool can_castle() const;
 	inline logic::Piece get_piece(logic::Square square) const;
 	inline logic::Color get_color(logic::Square square) const;
-	template <logic::Piece p>
-	inline void fill_array(board::Board& board) const;
-	template <logic::Color c>
-	inline void fill_array(board::Board& board) const;
-	template <logic::Color>
+	inline void set_square(logic::Square square, logic::Piece piece,
+			       logic::Color c);
 
 	// --- Move computation ---
 	// ++++++++ attack ++++++++
-	inline void compute_pawn_attack(logic::Square square);
-	template <logic::Direction d, logic::Color c>
-	inline void compute_ray_attack(logic::Square square);
-	template <logic::Color>
-	inline void compute_rook_attack(logic::Square square);
-	template <logic::Color>
-	inline void compute_bishop_attack(logic::Square square);
-	template <logic::Color>
-	inline void compute_knight_attack(logic::Square square);
-	template <logic::Color>
-	inline void compute_queen_attack(logic::Square square);
-	inline void compute_king_attack(logic::Square square);
-
-	template <logic::Piece p, logic::Color c>
-	inline void compute_attack(logic::Square square);
-	template <logic::Piece p, logic::Color c>
-	inline void compute_pieces_attack();
+	inline logic::Bitboard compute_piece_attack(logic::Square square) const;
+	void compute_all_attacks();
+	inline void update_attacks(logic::Bitboard changed);
 	template <logic::Color>
 	inline void compute_attacks();
 
 	// ++++++++ move ++++++++
 	template <logic::Direction d, logic::Color c>
 	inline void compute_ray_moves(logic::Square square);
+	template <int offset>
+	inline void add_pawn_moves(logic::Bitboard targets);
 	template <logic::Color>
-	inline void compute_pawn_moves(logic::Square square);
+	inline void compute_pawns_moves();
 	template <logic::Color>
 	inline void compute_rook_moves(logic::Square square);
 	template <logic::Color>
@@ -207,13 +323,20 @@ class Chessboard {
 	template <logic::Color>
 	inline void compute_castling();
 
-	template <logic::Color c, logic::Direction d>
-	inline void compute_pin();
+	template <logic::Color c>
+	inline void compute_checkers();
 	template <logic::Color c>
 	inline void compute_pins();
 	template <logic::Piece p, logic::Color c>
 	inline void compute_pieces_moves();
 
+	template <logic::Piece p, logic::Color c>
+	inline void compute_pieces_evasions(logic::Bitboard target);
+	template <logic::Color c>
+	inline void compute_pawns_evasions(logic::Bitboard target);
+	template <logic::Color c>
+	inline void compute_evasions();
+
 	template <logic::Color>
 	inline void compute_moves();
 	template <logic::Color>
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace logic {
+/**
+ * @brief Keys of the positions met since the last irreversible move, the
+ * only ones that can be repeated. Past 100 plies the game is drawn by the
+ * fifty-move rule, so the stack never needs more. Copies only copy the keys
+ * in use, as the chessboard is copied at every node of a search.
+ */
+class Key_history {
+	static constexpr unsigned int CAPACITY = 100;
+
+	uint64_t keys[CAPACITY];
+	unsigned int size = 0;
+
+       public:
+	Key_history() = default;
+	Key_history(const Key_history &other) : size(other.size) {
+		std::copy(other.keys, other.keys + size, keys);
+	};
+	Key_history &operator=(const Key_history &other) {
+		size = other.size;
+		std::copy(other.keys, other.keys + size, keys);
+		return *this;
+	};
+
+	/**
+	 * @brief Add the key of a position left by a reversible move, it is
+	 * dropped once the stack is full
+	 *
+	 * @param key Zobrist key
+	 */
+	void push(uint64_t key) {
+		if (size < CAPACITY) keys[size++] = key;
+	};
+	/**
+	 * @brief Forget every position, after an irreversible move
+	 */
+	void clear() { size = 0; };
+	/**
+	 * @brief Count the previous occurrences of a position, only every
+	 * other key can match as the side to move is part of the key
+	 *
+	 * @param key Zobrist key of the current position
+	 * @return unsigned int
+	 */
+	unsigned int count(uint64_t key) const {
+		unsigned int found = 0;
+		for (int i = int(size) - 2; i >= 0; i -= 2) {
+			found += keys[i] == key;
+		}
+		return found;
+	};
+};
+}  // namespace logic
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "logic/bitboard.hpp"
+
+namespace logic {
+/**
+ * @brief Result of the move generation for one position
+ */
+struct Move_set {
+	// Zobrist key of the position
+	uint64_t key;
+	Bitboard legal_moves[64];
+	Bitboard attacks;
+	Bitboard checkers;
+	Bitboard pinned;
+	unsigned int legal_move_count;
+};
+
+/**
+ * @brief Hash-indexed cache of move sets, so that positions met again skip
+ * the move generation. An entry is simply replaced on collision. It isn't
+ * thread safe, use one cache per thread.
+ */
+class Move_cache {
+	std::vector<Move_set> entries;
+	uint64_t mask;
+	uint64_t hits   = 0;
+	uint64_t probes = 0;
+
+       public:
+	/**
+	 * @brief Allocate the cache
+	 *
+	 * @param size Number of entries, rounded down to a power of two
+	 */
+	explicit Move_cache(size_t size = 1 << 14);
+
+	/**
+	 * @brief Look a position up
+	 *
+	 * @param key Zobrist key of the position
+	 * @return const Move_set* The entry, nullptr if the position isn't
+	 * cached
+	 */
+	const Move_set *find(uint64_t key) {
+		const Move_set &entry = entries[key & mask];
+		probes++;
+		if (entry.key != key) return nullptr;
+		hits++;
+		return &entry;
+	};
+	/**
+	 * @brief Get the entry to fill for a position, it replaces the one
+	 * stored there
+	 *
+	 * @param key Zobrist key of the position
+	 * @return Move_set&
+	 */
+	Move_set &slot(uint64_t key) { return entries[key & mask]; };
+
+	/**
+	 * @brief Get the number of lookups that found their position
+	 *
+	 * @return uint64_t
+	 */
+	uint64_t get_hits() const { return hits; };
+	/**
+	 * @brief Get the number of lookups
+	 *
+	 * @return uint64_t
+	 */
+	uint64_t get_probes() const { return probes; };
+	/**
+	 * @brief Get the share of lookups that found their position
+	 *
+	 * @return double Between 0 and 1, 0 before any lookup
+	 */
+	double get_hit_rate() const {
+		return probes ? double(hits) / double(probes) : 0;
+	};
+	/**
+	 * @brief Forget every position and reset the counters
+	 */
+	void clear();
+};
+}  // namespace logic
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "logic/bitboard.hpp"
+
+namespace logic {
+/**
+ * @brief Compact position, only what is needed to continue the game from it.
+ * It fits in 80 bytes so search, perft and position databases can copy and
+ * store it cheaply, a Chessboard can be built back from it.
+ */
+struct Position {
+	Bitboard color[2];
+	Bitboard pieces[6];
+	// Zobrist key
+	uint64_t key;
+	// square of the pawn that can be taken en passant, SQ_NONE otherwise
+	uint8_t enpassant;
+	// Color to move
+	uint8_t turn;
+	// Castling rights
+	uint8_t castling;
+	// plies since the last capture or pawn move, capped to 255
+	uint8_t halfmove_clock;
+
+	bool operator==(const Position &other) const = default;
+};
+
+static_assert(sizeof(Position) == 80, "Position must stay small");
+}  // namespace logic
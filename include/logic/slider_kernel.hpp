@@ -0,0 +1,37 @@
+#pragma once
+
+#include "logic/bitboard.hpp"
+
+namespace logic {
+// Kogge-Stone occluded fills giving the union of the attacks of a set of
+// sliders, all directions at once. Only bench uses them: the chessboard keeps
+// the attacks of each piece apart to update them incrementally, which a union
+// can't do.
+
+/**
+ * @brief Union of the attacks of a set of sliders, one direction after the
+ * other
+ *
+ * @param straight Sliders moving along lines and columns, rooks and queens
+ * @param diagonal Sliders moving along diagonals, bishops and queens
+ * @param empty Squares the rays go through
+ * @return Bitboard Attacked squares, including the first obstacle of each ray
+ */
+Bitboard slider_attacks_scalar(Bitboard straight, Bitboard diagonal,
+			       Bitboard empty);
+
+/**
+ * @brief AVX2 implementation of slider_attacks_scalar, the four directions
+ * going up the board in one vector and the four going down in another. It
+ * must only be called when has_avx2() is true.
+ */
+Bitboard slider_attacks_avx2(Bitboard straight, Bitboard diagonal,
+			     Bitboard empty);
+
+/**
+ * @brief Check if the CPU and the build support slider_attacks_avx2
+ *
+ * @return bool
+ */
+bool has_avx2();
+}  // namespace logic
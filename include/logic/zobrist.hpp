@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace logic {
+namespace zobrist {
+// splitmix64, good enough to fill the tables at compile time
+constexpr uint64_t next(uint64_t &state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15);
+	z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+	z          = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+	return z ^ (z >> 31);
+}
+
+struct Keys {
+	uint64_t pieces[2][6][64];
+	uint64_t castling[16];
+	uint64_t enpassant[8];
+	uint64_t side;
+};
+
+constexpr Keys generate() {
+	Keys keys{};
+	uint64_t state = 0x636865737321;
+	for (auto &color : keys.pieces) {
+		for (auto &piece : color) {
+			for (auto &square : piece) square = next(state);
+		}
+	}
+	// castling rights are hashed as a whole so they don't need to be
+	// independent
+	for (auto &castling : keys.castling) castling = next(state);
+	keys.castling[0] = 0;
+	for (auto &enpassant : keys.enpassant) enpassant = next(state);
+	keys.side = next(state);
+	return keys;
+}
+
+/**
+ * @brief Random keys of the Zobrist hashing: a position is hashed by xoring
+ * the key of each piece on its square, of the castling rights, of the column
+ * of the en passant pawn and of the side when black is to move
+ */
+inline constexpr Keys keys = generate();
+}  // namespace zobrist
+}  // namespace logic
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.hpp"
+#include "player/player.hpp"
+
+namespace net {
+constexpr uint8_t PROTOCOL_VERSION = 1;
+// bytes of a version 1 frame, length prefix included
+constexpr size_t FRAME_SIZE = 21;
+// longest frame accepted, later versions may append fields
+constexpr size_t MAX_FRAME_SIZE = 256;
+
+enum Frame_type : uint8_t {
+	// server: a game starts, action is the color of the player
+	START,
+	// server: the player has to move, move is the last move of the game
+	YOUR_TURN,
+	// server: the last answer was an invalid move, the player moves again
+	INVALID,
+	// server: a move of the game replayed after a RESYNC
+	HISTORY,
+	// server: the game is over, action is its GameState and move its last
+	// move
+	GAME_OVER,
+	// player: answer to YOUR_TURN or INVALID
+	MOVE,
+	// player: ask the moves of the game from the ply given by sequence
+	RESYNC,
+};
+
+/**
+ * @brief Message exchanged with a remote player. On the wire, in little
+ * endian: the length of the rest of the frame (2 bytes), the version, the
+ * type, the game (4 bytes), the sequence (2 bytes), the action, the move
+ * (2 bytes: from, to and promotion on 6, 6 and 4 bits) and the two clocks
+ * (4 bytes each).
+ */
+struct Frame {
+	Frame_type type = YOUR_TURN;
+	uint32_t game   = 0;
+	// ply of the move carried, or of the move asked for
+	uint16_t sequence = 0;
+	uint8_t action    = PLAY;
+	board::Move move;
+	// time the player has to answer, and has already used in the game
+	uint32_t time_left_ms = 0;
+	uint32_t time_used_ms = 0;
+};
+
+enum Decode_status {
+	// the frame is incomplete
+	NEED_MORE,
+	DECODED,
+	// the bytes can't be a frame, the connection can't go on
+	MALFORMED,
+};
+
+/**
+ * @brief Append the encoding of a frame to a buffer
+ *
+ * @param frame Frame to encode
+ * @param output Buffer to append to
+ */
+void encode(const Frame &frame, std::vector<uint8_t> &output);
+
+/**
+ * @brief Decode the first frame of a buffer. A frame of a later version is
+ * read as a version 1 one, the fields it appends after the known ones are
+ * skipped.
+ *
+ * @param data Bytes received
+ * @param size Number of bytes
+ * @param frame Decoded frame, only written on success
+ * @param consumed Bytes of the frame, only written on success
+ * @return Decode_status
+ */
+Decode_status decode(const uint8_t *data, size_t size, Frame &frame,
+		     size_t &consumed);
+
+/**
+ * @brief Check that the move of a frame answering YOUR_TURN or INVALID is
+ * one a player can send
+ *
+ * @param frame Frame received
+ * @return true if the action and the promotion are valid
+ */
+bool is_valid_answer(const Frame &frame);
+}  // namespace net
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "net/protocol.hpp"
+#include "player/async_player.hpp"
+
+namespace net {
+using Clock = std::chrono::steady_clock;
+
+// state of a remote player shared by the game and the network thread
+struct Seat {
+	std::mutex mutex;
+	uint64_t connection;
+	uint32_t game = 0;
+	// answer the game is waiting for, to the request of ply sequence
+	std::optional<Move_promise> promise;
+	uint16_t sequence;
+	Clock::time_point asked;
+	Clock::time_point deadline;
+	std::chrono::milliseconds timeout;
+	Clock::duration used{0};
+	// moves of the game the player knows of from first_ply, replayed on
+	// RESYNC
+	std::vector<board::Move> history;
+	uint16_t first_ply = 0;
+	bool has_history  = false;
+	// last move answered, in the history once the game goes on
+	board::Move proposed;
+	bool is_connected = true;
+};
+
+/**
+ * @brief Counters of a Remote_server
+ */
+struct Server_stats {
+	uint64_t accepted;
+	uint64_t disconnected;
+	uint64_t timeouts;
+	// frames that didn't decode or came when no answer was expected
+	uint64_t protocol_errors;
+	uint64_t resyncs;
+	uint64_t frames_received;
+	uint64_t frames_sent;
+	uint64_t bytes_received;
+	uint64_t bytes_sent;
+	// recv and send calls
+	uint64_t reads;
+	uint64_t writes;
+	// connections open
+	uint64_t connections;
+};
+
+class Remote_server;
+
+/**
+ * @brief Player on the other end of a connection of a Remote_server, which
+ * has to outlive it. A disconnection or a timeout makes it resign.
+ */
+class Remote_player : public Async_player {
+	Remote_server &server;
+	std::shared_ptr<Seat> seat;
+
+	void update_history(const Chessboard &chessboard);
+	Move_future request(const Chessboard &chessboard, Frame_type type);
+	void send(const Frame &frame, bool is_last = false);
+
+       public:
+	Remote_player(Remote_server &server, std::shared_ptr<Seat> seat)
+	    : server(server), seat(std::move(seat)){};
+
+	/**
+	 * @brief Set the identifier of the game sent in every frame, the
+	 * answers of the player have to carry it
+	 *
+	 * @param game Identifier of the game
+	 */
+	void set_game(uint32_t game);
+
+	void start_new_game(bool is_white) override;
+	Move_future play(const Chessboard &chessboard) override;
+	Move_future invalid_move(const Chessboard &chessboard) override;
+	void end(const Chessboard &chessboard) override;
+};
+
+/**
+ * @brief Non-blocking server of remote players, one thread waits with epoll
+ * on every connection. Each connection is a Remote_player given to the
+ * on_player function, the frames it sends answer the game it is in. The
+ * frames queued to a connection during a turn of the event loop leave in a
+ * single write.
+ */
+class Remote_server {
+	struct Connection {
+		int fd;
+		std::shared_ptr<Seat> seat;
+		// bytes of an incomplete frame
+		std::vector<uint8_t> input;
+		std::vector<uint8_t> output;
+		size_t output_sent  = 0;
+		bool is_writing     = false;
+		bool is_dirty       = false;
+		bool close_on_flush = false;
+	};
+
+	// requests of the games, carried out by the network thread
+	struct Command {
+		uint64_t connection;
+		Frame frame;
+		bool is_last;
+	};
+
+	int listener = -1;
+	int epoll    = -1;
+	// wakes the network thread up when commands are queued
+	int wakeup = -1;
+	uint16_t port;
+	std::chrono::milliseconds timeout;
+	std::function<void(std::unique_ptr<Remote_player>)> on_player;
+
+	// only used by the network thread
+	std::unordered_map<uint64_t, Connection> connections;
+	// connections with frames queued since the last flush
+	std::vector<uint64_t> dirty;
+	uint64_t next_id = 1;
+
+	std::mutex command_mutex;
+	std::vector<Command> commands;
+
+	std::mutex stats_mutex;
+	Server_stats stats{};
+
+	std::atomic<bool> is_stopped{false};
+	std::thread thread;
+
+	void run();
+	void accept_all();
+	bool read_all(uint64_t id, Connection &connection);
+	bool receive(uint64_t id, Connection &connection, const Frame &frame);
+	void resync(Connection &connection, const Frame &frame);
+	void queue(uint64_t id, Connection &connection, const Frame &frame);
+	bool flush(uint64_t id, Connection &connection);
+	void flush_all();
+	void carry_out_commands();
+	void check_timeouts();
+	void disconnect(uint64_t id);
+	void count(uint64_t Server_stats::*counter, uint64_t value = 1);
+
+       public:
+	/**
+	 * @brief Listen on a port and start the network thread
+	 *
+	 * @param port TCP port, 0 to let the system choose one
+	 * @param timeout Time a player has to answer before resigning
+	 * @param on_player Function called by the network thread with the
+	 * player of each new connection
+	 * @param address IPv4 address to listen on
+	 * @throw std::runtime_error if the port can't be listened on
+	 */
+	Remote_server(uint16_t port, std::chrono::milliseconds timeout,
+		      std::function<void(std::unique_ptr<Remote_player>)>
+			  on_player,
+		      const std::string &address = "0.0.0.0");
+	Remote_server(const Remote_server &)            = delete;
+	Remote_server(Remote_server &&)                 = delete;
+	Remote_server &operator=(const Remote_server &) = delete;
+	Remote_server &operator=(Remote_server &&)      = delete;
+	/**
+	 * @brief Stop the network thread and close every connection, the
+	 * players still expected to answer resign
+	 */
+	~Remote_server();
+
+	/**
+	 * @brief Get the port listened on
+	 *
+	 * @return uint16_t
+	 */
+	uint16_t get_port() const { return port; };
+	/**
+	 * @brief Get the counters
+	 *
+	 * @return Server_stats
+	 */
+	Server_stats get_stats();
+
+	/**
+	 * @brief Queue a frame to a connection, it can be called from any
+	 * thread
+	 *
+	 * @param connection Identifier of the connection
+	 * @param frame Frame to send
+	 * @param is_last Close the connection once the frame is sent
+	 */
+	void send(uint64_t connection, const Frame &frame,
+		  bool is_last = false);
+};
+
+/**
+ * @brief Raise the limit of open files of the process to its maximum, so a
+ * server can hold many connections
+ *
+ * @return size_t The new limit
+ */
+size_t raise_file_limit();
+}  // namespace net
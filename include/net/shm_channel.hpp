@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "net/protocol.hpp"
+
+namespace net {
+/**
+ * @brief Two-way link between two processes of the same machine, made of two
+ * single producer, single consumer rings in POSIX shared memory. The frames
+ * are the ones of the remote protocol. A reader with nothing to read spins a
+ * little, then sleeps on a futex the writer only wakes when someone sleeps.
+ */
+class Shm_channel {
+	struct Ring;
+	struct Shared;
+
+	std::string name;
+	Shared *shared = nullptr;
+	bool is_owner;
+	Ring *in;
+	Ring *out;
+	// bytes of an incomplete frame
+	std::vector<uint8_t> input;
+
+	bool read_ring();
+	void wait(Ring &ring, std::chrono::steady_clock::time_point deadline);
+
+       public:
+	/**
+	 * @brief Create the shared memory, or map the one created by the
+	 * other side
+	 *
+	 * @param name Name of the shared memory object, "/something"
+	 * @param create True on the side creating it, which removes it at the
+	 * end
+	 * @throw std::runtime_error if it can't be created or opened
+	 */
+	Shm_channel(const std::string &name, bool create);
+	Shm_channel(const Shm_channel &)            = delete;
+	Shm_channel(Shm_channel &&)                 = delete;
+	Shm_channel &operator=(const Shm_channel &) = delete;
+	Shm_channel &operator=(Shm_channel &&)      = delete;
+	/**
+	 * @brief Close the channel, the other side stops waiting
+	 */
+	~Shm_channel();
+
+	/**
+	 * @brief Send a frame, waiting while the ring is full
+	 *
+	 * @param frame Frame to send
+	 * @return true unless the other side closed the channel
+	 */
+	bool send(const Frame &frame);
+	/**
+	 * @brief Wait for the next frame
+	 *
+	 * @param frame Frame received
+	 * @param deadline Time to give up at
+	 * @return true if a frame came, false on timeout, when the other side
+	 * closed the channel or sent bytes that aren't a frame
+	 */
+	bool receive(Frame &frame,
+		     std::chrono::steady_clock::time_point deadline);
+};
+}  // namespace net
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string_view>
+
+#include "board.hpp"
+
+namespace notation {
+/**
+ * @brief Decode a promotion piece letter, either case
+ *
+ * @param letter One of N, B, R or Q
+ * @return board::Piece NO_PIECE if the letter is not a promotion piece
+ */
+board::Piece parse_promotion(char letter);
+
+/**
+ * @brief Decode a move typed by a player or sent by a front-end, without
+ * allocating. Accepted forms are coordinates with an optional dash (e2e4,
+ * e2-e4), an optional promotion suffix (e7e8q, e7e8=Q, which also covers UCI
+ * notation) and castling (O-O, o-o-o, 0-0).
+ *
+ * @param input Text of the move
+ * @param color Color of the player, needed to decode castling
+ * @param move Decoded move, only written on success, the promotion is
+ * NO_PIECE when not given
+ * @return true if the text is a well formed move, false otherwise. The move
+ * itself may still be illegal.
+ */
+bool parse_move(std::string_view input, board::Color color, board::Move &move);
+}  // namespace notation
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logic/chessboard.hpp"
+
+namespace notation {
+/**
+ * @brief Read-only memory mapping of a whole file, the views handed out by
+ * the readers point directly into it so nothing is copied
+ */
+class Mapped_file {
+	const char *data = nullptr;
+	size_t size      = 0;
+
+       public:
+	/**
+	 * @brief Map a file in memory
+	 *
+	 * @param path Path of the file
+	 * @throw std::runtime_error if the file can't be opened or mapped
+	 */
+	explicit Mapped_file(const std::string &path);
+	Mapped_file(const Mapped_file &)            = delete;
+	Mapped_file(Mapped_file &&)                 = delete;
+	Mapped_file &operator=(const Mapped_file &) = delete;
+	Mapped_file &operator=(Mapped_file &&)      = delete;
+	~Mapped_file();
+
+	std::string_view get_view() const { return {data, size}; };
+};
+
+/**
+ * @brief Tag pair of a PGN game, eg. [White "Morphy"]
+ */
+struct Pgn_tag {
+	std::string_view name;
+	std::string_view value;
+};
+
+/**
+ * @brief A game as found in the file: the tag pairs and the raw movetext
+ */
+struct Pgn_game {
+	std::vector<Pgn_tag> tags;
+	std::string_view movetext;
+
+	/**
+	 * @brief Get the value of a tag
+	 *
+	 * @param name Name of the tag
+	 * @return The value or an empty view if the tag is absent
+	 */
+	std::string_view get_tag(std::string_view name) const;
+};
+
+/**
+ * @brief Split a PGN text into games without copying it
+ */
+class Pgn_reader {
+	std::string_view text;
+	size_t offset = 0;
+
+       public:
+	explicit Pgn_reader(std::string_view text) : text(text){};
+
+	/**
+	 * @brief Read the next game, the tags vector of the game is reused so
+	 * reading a whole file doesn't allocate once it has grown
+	 *
+	 * @param game Game to fill
+	 * @return true if a game was read, false at the end of the text
+	 */
+	bool next_game(Pgn_game &game);
+};
+
+enum Pgn_token_type {
+	PGN_MOVE,
+	PGN_RESULT,
+	PGN_END,
+};
+
+/**
+ * @brief Token of a movetext, move numbers, comments, NAGs and variations
+ * are skipped by the tokenizer
+ */
+struct Pgn_token {
+	Pgn_token_type type;
+	std::string_view text;
+};
+
+/**
+ * @brief Iterate over the moves of a movetext without copying it
+ */
+class Movetext_tokenizer {
+	std::string_view text;
+	size_t offset = 0;
+
+       public:
+	explicit Movetext_tokenizer(std::string_view text) : text(text){};
+
+	/**
+	 * @brief Get the next move or the result of the game
+	 *
+	 * @return Pgn_token PGN_END once the movetext is exhausted
+	 */
+	Pgn_token next();
+};
+
+/**
+ * @brief Outcome of the replay of a game
+ */
+struct Pgn_replay {
+	bool is_valid   = true;
+	bool is_skipped = false;
+	size_t moves    = 0;
+	std::string_view bad_move;
+	Chessboard chessboard;
+};
+
+/**
+ * @brief Replay the movetext of a game from the initial position, decoding
+ * every move with parse_san, and check the result of a game ended on the
+ * board. Games starting from a custom position (FEN tag) are skipped.
+ *
+ * @param game Game to replay
+ * @return Pgn_replay
+ */
+Pgn_replay replay_game(const Pgn_game &game);
+
+/**
+ * @brief Split a PGN text in at most count chunks of whole games so they can
+ * be read in parallel
+ *
+ * @param text PGN text
+ * @param count Number of chunks wanted
+ * @return Chunks in order, covering the whole text
+ */
+std::vector<std::string_view> split_games(std::string_view text, size_t count);
+}  // namespace notation
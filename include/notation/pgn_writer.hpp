@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "logic/chessboard.hpp"
+
+namespace notation {
+/**
+ * @brief Export games in PGN. A game is built in a buffer reused from one
+ * game to the next and written with a single write call when it ends, the
+ * file is opened in append mode so several writers can share it.
+ */
+class Pgn_writer {
+	int fd;
+	bool is_owner;
+	std::string game;
+	std::string movetext;
+	std::string white = "?";
+	std::string black = "?";
+	std::string date;
+	size_t line_length = 0;
+	unsigned int ply   = 0;
+	unsigned int round = 0;
+
+	void append_token(std::string_view token);
+	void write_all(std::string_view text);
+
+       public:
+	/**
+	 * @brief Open a PGN file, the games are appended to it
+	 *
+	 * @param path Path of the file
+	 * @throw std::runtime_error if the file can't be opened
+	 */
+	explicit Pgn_writer(const std::string &path);
+	/**
+	 * @brief Write the games to an already opened file descriptor (eg.
+	 * STDOUT_FILENO), it is not closed by the writer
+	 *
+	 * @param fd File descriptor
+	 */
+	explicit Pgn_writer(int fd);
+	Pgn_writer(const Pgn_writer &)            = delete;
+	Pgn_writer(Pgn_writer &&)                 = delete;
+	Pgn_writer &operator=(const Pgn_writer &) = delete;
+	Pgn_writer &operator=(Pgn_writer &&)      = delete;
+	~Pgn_writer();
+
+	/**
+	 * @brief Set the names written in the White and Black tags
+	 *
+	 * @param white Name of the white player
+	 * @param black Name of the black player
+	 */
+	void set_players(std::string white, std::string black);
+
+	/**
+	 * @brief Forget the moves of the previous game
+	 */
+	void start_game();
+	/**
+	 * @brief Add a move to the current game
+	 *
+	 * @param san Move written by format_san, without suffix
+	 * @param chessboard Position after the move, used for the suffix
+	 */
+	void add_move(std::string_view san, const Chessboard &chessboard);
+	/**
+	 * @brief Write the tags, the movetext and the result of the current
+	 * game in one system call
+	 *
+	 * @param state Final state of the game
+	 * @throw std::runtime_error if the write fails
+	 */
+	void end_game(GameState state);
+};
+}  // namespace notation
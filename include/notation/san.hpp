@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "board.hpp"
+#include "logic/chessboard.hpp"
+
+namespace notation {
+/**
+ * @brief Size of a buffer large enough for any SAN move, suffix included
+ * (eg. Qh4xe1=Q#)
+ */
+constexpr size_t SAN_MAX_LENGTH = 12;
+
+/**
+ * @brief Decode a move in Standard Algebraic Notation (eg. Nbd7, exd8=Q+,
+ * O-O-O) against the legal moves of the chessboard. Long forms with the
+ * complete origin square (eg. Ne2xc3, d4xc3) are accepted too.
+ *
+ * @param san Move text, check and annotation suffixes are ignored
+ * @param chessboard Position in which the move is played
+ * @param move Decoded move, only written on success
+ * @return true if the text designates exactly one legal move, false otherwise
+ */
+bool parse_san(std::string_view san, const Chessboard &chessboard,
+	       board::Move &move);
+
+/**
+ * @brief Write a legal move in Standard Algebraic Notation, the origin is
+ * only given when another piece of the same type can reach the destination.
+ * The check suffix is not written, see format_check.
+ *
+ * @param chessboard Position before the move
+ * @param move Legal move
+ * @param out Buffer of at least SAN_MAX_LENGTH chars, not null terminated
+ * @return Number of chars written
+ */
+size_t format_san(const Chessboard &chessboard, board::Move move, char *out);
+
+/**
+ * @brief Write the suffix of the move that led to a position, '#' for a
+ * checkmate and '+' for a check
+ *
+ * @param chessboard Position after the move
+ * @param out Buffer of at least one char, not null terminated
+ * @return Number of chars written
+ */
+size_t format_check(const Chessboard &chessboard, char *out);
+}  // namespace notation
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "player/player.hpp"
+#include "utils/executor.hpp"
+
+// state shared by a Move_promise and its Move_future
+struct Move_state {
+	std::mutex mutex;
+	std::optional<Player_move> value;
+	std::coroutine_handle<> waiter;
+	Executor *executor = nullptr;
+};
+
+/**
+ * @brief Answer of a player, awaited by the game. The coroutine awaiting it
+ * is suspended until the answer is set, then resumed by its executor.
+ */
+class Move_future {
+	std::shared_ptr<Move_state> state;
+
+       public:
+	explicit Move_future(std::shared_ptr<Move_state> state)
+	    : state(std::move(state)){};
+
+	bool await_ready() const {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return state->value.has_value();
+	};
+	// the promise type of the awaiting coroutine gives the executor
+	template <typename Promise>
+	bool await_suspend(std::coroutine_handle<Promise> coroutine) {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		// the answer may have come since await_ready
+		if (state->value) return false;
+		state->waiter   = coroutine;
+		state->executor = coroutine.promise().executor;
+		return true;
+	}
+	Player_move await_resume() {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return *state->value;
+	};
+};
+
+/**
+ * @brief Producer side of a Move_future, kept by the player until it knows
+ * its answer
+ */
+class Move_promise {
+	std::shared_ptr<Move_state> state = std::make_shared<Move_state>();
+
+       public:
+	/**
+	 * @brief Get the future to return to the game
+	 *
+	 * @return Move_future
+	 */
+	Move_future get_future() const { return Move_future(state); };
+	/**
+	 * @brief Give the answer, the game waiting for it is queued on its
+	 * executor. It can be called from any thread, once.
+	 *
+	 * @param move Action and move of the player
+	 * @throw std::logic_error if the answer was already given
+	 */
+	void set_value(Player_move move) {
+		std::coroutine_handle<> waiter;
+		Executor *executor;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (state->value) {
+				throw std::logic_error("Answer already given");
+			}
+			state->value = move;
+			waiter       = std::exchange(state->waiter, nullptr);
+			executor     = state->executor;
+		}
+		if (waiter) executor->post(waiter);
+	};
+};
+
+/**
+ * @brief Player answering through futures, a game waiting for its answer
+ * doesn't hold any thread
+ */
+class Async_player {
+       public:
+	Async_player()          = default;
+	virtual ~Async_player() = default;
+
+	/**
+	 * @brief Method called by the controller when the game start
+	 *
+	 * @param is_white True if the player is white, false otherwise
+	 */
+	virtual void start_new_game(bool is_white) = 0;
+	/**
+	 * @brief Method called by the controller when the player has to move
+	 *
+	 * @param chessboard Current position, it stays valid until the
+	 * answer is given
+	 * @return Move_future The action and the move of the player
+	 */
+	virtual Move_future play(const Chessboard &chessboard) = 0;
+	/**
+	 * @brief Method called by the controller when the player try to do an
+	 * invalid move
+	 *
+	 * @param chessboard Current position
+	 * @return Move_future The action and the move of the player
+	 */
+	virtual Move_future invalid_move(const Chessboard &chessboard) = 0;
+	/**
+	 * @brief Method called by the controller when the game ends
+	 *
+	 * @param chessboard Final position
+	 */
+	virtual void end(const Chessboard &chessboard) = 0;
+};
+
+/**
+ * @brief Adapter of a synchronous Player, it answers before returning the
+ * future, so a blocking player still blocks the thread playing the game
+ */
+class Player_adapter : public Async_player {
+	std::unique_ptr<Player> player;
+
+       public:
+	explicit Player_adapter(std::unique_ptr<Player> player)
+	    : player(std::move(player)){};
+
+	void start_new_game(bool is_white) override {
+		player->start_new_game(is_white);
+	};
+	Move_future play(const Chessboard &chessboard) override {
+		Move_promise promise;
+		promise.set_value(player->play(chessboard));
+		return promise.get_future();
+	};
+	Move_future invalid_move(const Chessboard &chessboard) override {
+		Move_promise promise;
+		promise.set_value(player->invalid_move(chessboard));
+		return promise.get_future();
+	};
+	void end(const Chessboard &chessboard) override {
+		(void)chessboard;
+		player->end();
+	};
+};
@@ -37,7 +37,7 @@ class Player {
 	 * @return Player_move The action and the move that the player want to
 	 * do
 	 */
-	virtual Player_move play(Chessboard chessboard) = 0;
+	virtual Player_move play(const Chessboard &chessboard) = 0;
 	/**
 	 * @brief Method called by the controller when the player try to do an
 	 * invalid move
@@ -46,7 +46,7 @@ class Player {
 	 * @return Player_move The action and the move that the player want to
 	 * do
 	 */
-	virtual Player_move invalid_move(Chessboard chessboard) = 0;
+	virtual Player_move invalid_move(const Chessboard &chessboard) = 0;
 	/**
 	 * @brief Method called by the controller when the game ends
 	 *
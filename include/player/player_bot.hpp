@@ -1,18 +1,51 @@
 #pragma once
 
+#include <iostream>
+#include <memory>
+
+#include "logic/move_cache.hpp"
 #include "player/player.hpp"
 
 /**
- * @brief Bot player with a depth of 4 wich is sufficient to play at a average
- * elo and fast
+ * @brief Parameters of the bot, a depth of 4 is sufficient to play at a
+ * average elo and fast
+ */
+struct Bot_params {
+	// plies searched
+	int depth = 4;
+	// penalty per 200 legal moves left to the opponent
+	double mobility = 0.01;
+	// entries of the move cache, 0 to search without one
+	size_t cache = 0;
+};
+
+/**
+ * @brief Bot player searching the moves with the minimax algorithm
  */
 class Player_bot : public Player {
+	std::ostream &out;
 	bool is_white;
 	bool is_started = false;
-	int max_depth   = 4;
+	Bot_params params;
+	// move sets of the positions searched, kept from one move to the next,
+	// null without Bot_params::cache
+	std::unique_ptr<logic::Move_cache> cache;
 
        public:
-	Player_bot()                              = default;
+	/**
+	 * @brief Construct a new Player_bot object
+	 *
+	 * @param params Search parameters
+	 * @param out Stream where the moves played are written
+	 */
+	explicit Player_bot(Bot_params params = {},
+			    std::ostream &out = std::cout)
+	    : out(out), params(params) {
+		if (params.cache > 0) {
+			cache = std::make_unique<logic::Move_cache>(
+			    params.cache);
+		}
+	};
 	Player_bot(const Player_bot &)            = delete;
 	Player_bot(Player_bot &&)                 = delete;
 	Player_bot &operator=(const Player_bot &) = delete;
@@ -33,14 +66,14 @@ class Player_bot : public Player {
 	 * @return Player_move The action and the move that the player want to
 	 * do
 	 */
-	Player_move play(Chessboard chessboard) override;
+	Player_move play(const Chessboard &chessboard) override;
 	/**
 	 * @brief Simply crash should not happen
 	 *
 	 * @param chessboard chessboard
 	 * @return Doesn't return
 	 */
-	Player_move invalid_move(Chessboard chessboard) override;
+	Player_move invalid_move(const Chessboard &chessboard) override;
 	/**
 	 * @brief Do nothing
 	 *
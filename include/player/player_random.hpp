@@ -30,14 +30,14 @@ class Player_random : public Player {
 	 * @return Player_move The action and the move that the player want to
 	 * do
 	 */
-	Player_move play(Chessboard chessboard) override;
+	Player_move play(const Chessboard &chessboard) override;
 	/**
 	 * @brief Simply crash should not happen
 	 *
 	 * @param chessboard Chessboard Object
 	 * @return Doesn't return
 	 */
-	Player_move invalid_move(Chessboard chessboard) override;
+	Player_move invalid_move(const Chessboard &chessboard) override;
 	/**
 	 * @brief Do nothing
 	 *
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "net/shm_channel.hpp"
+#include "player/player.hpp"
+
+/**
+ * @brief Player in another process of the same machine, reached through a
+ * Shm_channel with the frames of the remote protocol. The other process runs
+ * the engine mode. A timeout or a closed channel makes it resign.
+ */
+class Player_shm : public Player {
+	net::Shm_channel channel;
+	std::chrono::milliseconds timeout;
+	uint32_t game = 0;
+
+	Player_move request(const Chessboard &chessboard, net::Frame_type type);
+
+       public:
+	/**
+	 * @brief Create the shared memory the engine connects to
+	 *
+	 * @param name Name of the shared memory object, "/something"
+	 * @param timeout Time the engine has to answer
+	 * @throw std::runtime_error if it can't be created
+	 */
+	explicit Player_shm(const std::string &name,
+			    std::chrono::milliseconds timeout =
+				std::chrono::seconds(30))
+	    : channel(name, true), timeout(timeout){};
+	Player_shm(const Player_shm &)            = delete;
+	Player_shm(Player_shm &&)                 = delete;
+	Player_shm &operator=(const Player_shm &) = delete;
+	Player_shm &operator=(Player_shm &&)      = delete;
+	~Player_shm() override                    = default;
+
+	void start_new_game(bool is_white) override;
+	Player_move play(const Chessboard &chessboard) override;
+	Player_move invalid_move(const Chessboard &chessboard) override;
+	void end() override;
+};
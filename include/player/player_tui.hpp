@@ -1,17 +1,27 @@
 #pragma once
 
+#include <iostream>
+
 #include "player/player.hpp"
 
 /**
  * @brief Simple player that ask for input in the terminal
  */
 class Player_tui : public Player {
-	bool parse_move(std::string input, board::Move &move);
+	std::istream &in;
+	std::ostream &out;
 	bool is_white;
 	bool is_started = false;
 
        public:
-	Player_tui()                              = default;
+	/**
+	 * @brief Construct a new Player_tui object
+	 *
+	 * @param in Stream where the moves are read, the terminal by default
+	 * @param out Stream where the prompts are written
+	 */
+	Player_tui(std::istream &in = std::cin, std::ostream &out = std::cout)
+	    : in(in), out(out){};
 	Player_tui(const Player_tui &)            = delete;
 	Player_tui(Player_tui &&)                 = delete;
 	Player_tui &operator=(const Player_tui &) = delete;
@@ -25,20 +35,21 @@ class Player_tui : public Player {
 	 */
 	void start_new_game(bool is_white) override;
 	/**
-	 * @brief Ask for input in the terminal
+	 * @brief Ask for input in the terminal, end the game when the input
+	 * is exhausted
 	 *
 	 * @param chessboard Chessboard Object
 	 * @return Player_move The action and the move that the player want to
 	 * do
 	 */
-	Player_move play(Chessboard chessboard) override;
+	Player_move play(const Chessboard &chessboard) override;
 	/**
 	 * @brief Print an error message in the terminal and ask for a new input
 	 *
 	 * @param chessboard Chessboard Object
 	 * @return The action and the move that the player want to do
 	 */
-	Player_move invalid_move(Chessboard chessboard) override;
+	Player_move invalid_move(const Chessboard &chessboard) override;
 	/**
 	 * @brief Do nothing
 	 *
@@ -0,0 +1,11 @@
+#pragma once
+
+/**
+ * @brief Benchmark the move generator: perft on reference positions, checked
+ * against the known node counts, again with a move cache, then the slider
+ * attack generators on the positions met during the perft.
+ *
+ * @param depth Perft depth, capped to the known counts of each position
+ * @return int 0 if every count and every generator agree, 1 otherwise
+ */
+int bench(int depth);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Play as the engine of a Player_shm of another process, until it
+ * closes the channel
+ *
+ * @param name Name of the shared memory created by the Player_shm
+ * @param type Type of the player, see make_player
+ * @return int 1 if the shared memory can't be opened
+ * @throw std::invalid_argument if the type is unknown
+ */
+int engine(const std::string &name, const std::string &type);
+
+/**
+ * @brief Measure the round trip of a frame between two processes, through
+ * a Shm_channel and through a TCP connection on the loopback interface
+ *
+ * @param round_trips Number of frames sent back and forth on each transport
+ * @return int 0
+ */
+int transport_bench(size_t round_trips);
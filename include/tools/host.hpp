@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "player/player.hpp"
+
+/**
+ * @brief Create a player of a hosted type
+ *
+ * @param type "random" or "bot[:parameters]" with the parameters of
+ * parse_bot_params
+ * @param out Stream the bot writes its moves to
+ * @return std::unique_ptr<Player>
+ * @throw std::invalid_argument if the type is unknown
+ */
+std::unique_ptr<Player> make_player(const std::string &type,
+				    std::ostream &out);
+
+/**
+ * @brief Host many games at once on a Game_scheduler, without any view, then
+ * print the results and the counters of the scheduler
+ *
+ * @param games Number of games, all started at once
+ * @param threads Number of workers
+ * @param white Type of the white players, see make_player
+ * @param black Type of the black players
+ * @return int 0 once every game is over
+ */
+int host(size_t games, size_t threads, const std::string &white,
+	 const std::string &black);
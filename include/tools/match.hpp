@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "player/player_bot.hpp"
+
+/**
+ * @brief Settings of a match between two bots
+ */
+struct Match_options {
+	size_t games   = 100;
+	size_t threads = 1;
+	// parameters of the engines A and B
+	Bot_params engines[2];
+	// file of openings, one line of SAN moves each, a built-in set if empty
+	std::string openings;
+	// SPRT hypotheses, Elo of A over B, and error rates
+	double elo0  = 0;
+	double elo1  = 5;
+	double alpha = 0.05;
+	double beta  = 0.05;
+};
+
+/**
+ * @brief Parse the parameters of a bot
+ *
+ * @param text "depth" or "depth:mobility"
+ * @return Bot_params
+ * @throw std::invalid_argument if the text isn't of this form
+ */
+Bot_params parse_bot_params(const std::string &text);
+
+/**
+ * @brief Play a match between two bots on a thread pool, without any view.
+ * Each opening is played twice with the colors swapped. The score of A is
+ * printed after each game with its Elo estimate and the log-likelihood ratio
+ * of the SPRT, the remaining games are skipped once the SPRT concludes.
+ *
+ * @param options Settings of the match
+ * @return int 0 once the match is over, 1 if an opening is invalid
+ */
+int match(const Match_options &options);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Replay every game of the PGN files in parallel, report the illegal
+ * moves and the throughput in games/sec and moves/sec
+ *
+ * @param paths PGN files to check
+ * @param threads Number of workers
+ * @return int 0 if every game is legal, 1 otherwise
+ */
+int pgn_check(const std::vector<std::string> &paths, size_t threads);
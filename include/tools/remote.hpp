@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Serve remote players forever, each two connections play a game
+ * together, the first one with white. The counters are printed every ten
+ * seconds.
+ *
+ * @param port TCP port to listen on
+ * @param threads Number of workers playing the games
+ * @param timeout Time a player has to answer before resigning
+ * @return int 1 if the port can't be listened on
+ */
+int serve(uint16_t port, size_t threads, std::chrono::milliseconds timeout);
+
+/**
+ * @brief Connect many random clients to a server on the loopback interface
+ * and let them play each other. The clients split their frames in two
+ * writes, one in 32 disconnects during its game, one in 32 stops answering
+ * and one in 32 forgets the game and asks for its moves again.
+ *
+ * @param clients Number of clients, rounded up to an even number
+ * @param threads Number of workers playing the games
+ * @param timeout Time a player has to answer before resigning
+ * @return int 0 if every game ended without any protocol error, and every
+ * client knew the final position
+ */
+int loopback(size_t clients, size_t threads,
+	     std::chrono::milliseconds timeout);
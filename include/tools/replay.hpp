@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Replay game transcripts in process on a thread pool. A transcript is
+ * the input of a game, one command per line, lines containing '#' are
+ * comments and the last line is the expected final position and result as
+ * printed by View_tui::end.
+ *
+ * @param paths Transcripts, or directories whose .txt files are transcripts
+ * @param threads Number of workers
+ * @return int 0 if every game ends as expected, 1 otherwise
+ */
+int replay(const std::vector<std::string> &paths, size_t threads);
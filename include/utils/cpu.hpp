@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+
+// Hot functions marked CPU_DISPATCH are compiled for several instruction set
+// levels, the loader picks the best one for the CPU from CPUID. The
+// sanitizers aren't set up yet when the loader runs the resolvers.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__) && \
+    !defined(__SANITIZE_THREAD__) && !defined(__SANITIZE_ADDRESS__)
+#define CPU_DISPATCH_ENABLED 1
+#endif
+
+#ifdef CPU_DISPATCH_ENABLED
+#define CPU_DISPATCH \
+	__attribute__((target_clones("arch=x86-64-v3", "popcnt", "default")))
+#else
+#define CPU_DISPATCH
+#endif
+
+/**
+ * @brief Instruction set extensions used by the hot kernels
+ */
+struct Cpu_features {
+	bool popcnt = false;
+	bool bmi2   = false;
+	bool avx2   = false;
+};
+
+/**
+ * @brief Get the features of the CPU running the program, read once from
+ * CPUID
+ *
+ * @return const Cpu_features&
+ */
+const Cpu_features &cpu_features();
+
+/**
+ * @brief Get the version of the CPU_DISPATCH functions run on this CPU
+ *
+ * @return std::string_view "x86-64-v3" (AVX2, BMI2, POPCNT...), "popcnt" or
+ * "default"
+ */
+std::string_view cpu_dispatch_level();
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief Something that resumes suspended coroutines, on its own threads
+ */
+class Executor {
+       public:
+	Executor()          = default;
+	virtual ~Executor() = default;
+
+	/**
+	 * @brief Queue a coroutine to resume, it can be called from any thread
+	 *
+	 * @param coroutine Suspended coroutine
+	 */
+	virtual void post(std::coroutine_handle<> coroutine) = 0;
+};
+
+/**
+ * @brief Executor resuming the coroutines on the thread calling run_one(),
+ * to drive coroutines from synchronous code
+ */
+class Run_loop : public Executor {
+	std::mutex mutex;
+	std::condition_variable posted;
+	std::deque<std::coroutine_handle<>> coroutines;
+
+       public:
+	void post(std::coroutine_handle<> coroutine) override {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			coroutines.push_back(coroutine);
+		}
+		posted.notify_one();
+	};
+
+	/**
+	 * @brief Resume the first coroutine queued, wait for one if there is
+	 * none
+	 */
+	void run_one() {
+		std::unique_lock<std::mutex> lock(mutex);
+		posted.wait(lock, [this] { return !coroutines.empty(); });
+		std::coroutine_handle<> coroutine = coroutines.front();
+		coroutines.pop_front();
+		lock.unlock();
+		coroutine.resume();
+	};
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer thread and one
+ * consumer thread. The elements stay in place, the consumer reads the front
+ * one before popping it.
+ *
+ * @tparam T Type of the elements, default constructible and copyable
+ * @tparam N Capacity, a power of two
+ */
+template <typename T, size_t N>
+class Spsc_queue {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "N is a power of two");
+
+	// next slot written, only changed by the producer
+	alignas(64) std::atomic<size_t> head{0};
+	// next slot read, only changed by the consumer
+	alignas(64) std::atomic<size_t> tail{0};
+	T slots[N];
+
+       public:
+	/**
+	 * @brief Add an element at the back, producer only
+	 *
+	 * @param value Element to copy
+	 * @return true unless the queue is full
+	 */
+	bool try_push(const T &value) {
+		const size_t position = head.load(std::memory_order_relaxed);
+		if (position - tail.load(std::memory_order_acquire) == N) {
+			return false;
+		}
+		slots[position % N] = value;
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	};
+	/**
+	 * @brief Get the front element, consumer only
+	 *
+	 * @return T* The element, valid until pop, nullptr if the queue is
+	 * empty
+	 */
+	T *front() {
+		const size_t position = tail.load(std::memory_order_relaxed);
+		if (head.load(std::memory_order_acquire) == position) {
+			return nullptr;
+		}
+		return &slots[position % N];
+	};
+	/**
+	 * @brief Remove the front element, consumer only, after front returned
+	 * it
+	 */
+	void pop() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1,
+			   std::memory_order_release);
+	};
+};
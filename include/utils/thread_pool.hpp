@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads consuming a FIFO queue of tasks
+ */
+class Thread_pool {
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable task_available;
+	std::condition_variable all_done;
+	std::exception_ptr error;
+	size_t active   = 0;
+	bool is_stopped = false;
+
+	void run();
+
+       public:
+	/**
+	 * @brief Start the workers
+	 *
+	 * @param count Number of workers, one per core by default
+	 */
+	explicit Thread_pool(size_t count = default_size());
+	Thread_pool(const Thread_pool &)            = delete;
+	Thread_pool(Thread_pool &&)                 = delete;
+	Thread_pool &operator=(const Thread_pool &) = delete;
+	Thread_pool &operator=(Thread_pool &&)      = delete;
+	/**
+	 * @brief Finish the queued tasks and join the workers
+	 */
+	~Thread_pool();
+
+	/**
+	 * @brief Queue a task, it will be run by the first idle worker
+	 *
+	 * @param task Task to run
+	 */
+	void submit(std::function<void()> task);
+	/**
+	 * @brief Block until every queued task is done, rethrow the first
+	 * exception thrown by a task if any
+	 */
+	void wait();
+
+	/**
+	 * @brief Get the number of workers
+	 *
+	 * @return size_t
+	 */
+	size_t size() const { return workers.size(); };
+
+	/**
+	 * @brief Number of hardware threads, at least one
+	 *
+	 * @return size_t
+	 */
+	static size_t default_size();
+};
@@ -8,9 +8,14 @@
 class View_noop : public View {
        public:
 	View_noop() = default;
-	View_noop(Chessboard){};
 
-	void start_new_game(Chessboard board) override { (void)board; }
-	void update(Chessboard board) override { (void)board; }
-	void end() override {}
+	void start_new_game(const Chessboard &chessboard) override {
+		(void)chessboard;
+	}
+	void update(const Move_event &event,
+		    const Chessboard &chessboard) override {
+		(void)event;
+		(void)chessboard;
+	}
+	void end(const Chessboard &chessboard) override { (void)chessboard; }
 };
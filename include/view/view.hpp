@@ -1,31 +1,50 @@
 #pragma once
 
+#include <cstdint>
+
 #include "logic/chessboard.hpp"
 
 /**
- * @brief Class that render the game
+ * @brief What a move changed, enough to follow the game without looking at
+ * the whole position
+ */
+struct Move_event {
+	board::Move move;
+	// piece taken by the move, board::xx if none
+	board::Colored_piece captured;
+	// state of the game after the move
+	GameState state;
+	// Zobrist key of the position after the move
+	uint64_t key;
+};
+
+/**
+ * @brief Class that render the game. The chessboards given are the one of the
+ * controller, only valid during the call.
  */
 class View {
        public:
-	View() = default;
-	View(Chessboard);
+	View()          = default;
 	virtual ~View() = default;
 
 	/**
 	 * @brief First method called by the controller
 	 *
-	 * @param board Chessboard Object
+	 * @param chessboard Initial position
 	 */
-	virtual void start_new_game(Chessboard board) = 0;
+	virtual void start_new_game(const Chessboard &chessboard) = 0;
 	/**
 	 * @brief Method called by the controller after each move
 	 *
-	 * @param board Chessboard Object
+	 * @param event The move and what it changed
+	 * @param chessboard Position after the move
 	 */
-	virtual void update(Chessboard board) = 0;
+	virtual void update(const Move_event &event,
+			    const Chessboard &chessboard) = 0;
 	/**
 	 * @brief Method called by the controller when the game ends
 	 *
+	 * @param chessboard Final position, with the result of the game
 	 */
-	virtual void end() = 0;
+	virtual void end(const Chessboard &chessboard) = 0;
 };
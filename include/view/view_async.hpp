@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "utils/spsc_queue.hpp"
+#include "view/view.hpp"
+
+/**
+ * @brief View rendering another one on its own thread, so a slow output
+ * doesn't slow the game down. The game thread publishes the events without
+ * any lock, the renderer thread calls the view in the same order with its own
+ * copy of the chessboard. A view following the moves one by one needs
+ * BACKPRESSURE, with DROP_TO_LATEST it only gets the latest one. The text
+ * written by the game thread to get_log() is printed by the renderer between
+ * the same events, so it stays in order with the boards.
+ */
+class View_async : public View {
+       public:
+	// what the game thread does when the renderer is behind
+	enum Policy {
+		// wait for the renderer once the queue is full
+		BACKPRESSURE,
+		// only render the latest position, never wait for the renderer
+		DROP_TO_LATEST,
+	};
+
+       private:
+	struct Event {
+		enum Type { START, UPDATE, END, LOG };
+		Type type = START;
+		// order of the event among all of them
+		uint64_t sequence = 0;
+		Move_event move   = {};
+		Chessboard chessboard;
+		std::string text = {};
+	};
+	// text of the log, published as an event at each flush
+	class Log_buffer : public std::stringbuf {
+		View_async &owner;
+
+	       public:
+		explicit Log_buffer(View_async &owner) : owner(owner){};
+		int sync() override;
+	};
+	static constexpr uint8_t FRESH = 4;
+
+	std::unique_ptr<View> view;
+	Policy policy;
+	std::ostream &out;
+	Log_buffer log_buffer{*this};
+	std::ostream log{&log_buffer};
+	// every event, or only the start and the end with DROP_TO_LATEST
+	Spsc_queue<Event, 64> events;
+	// triple buffer of the latest update with DROP_TO_LATEST: the game
+	// thread writes one slot, the renderer reads one, they swap theirs
+	// with the middle one
+	Event latest[3];
+	std::atomic<uint8_t> middle{1};
+	uint8_t back  = 0;
+	uint8_t front = 2;
+
+	// game thread only
+	uint64_t sequence = 0;
+	Event last_update;
+
+	// bumped by the game thread at each event, the renderer waits on it
+	std::atomic<uint32_t> published{0};
+	// bumped by the renderer at each event taken from the queue
+	std::atomic<uint32_t> consumed{0};
+	std::atomic<uint64_t> dropped{0};
+	std::atomic<bool> is_stopped{false};
+	// last member, started once the others are ready
+	std::thread renderer;
+
+	void push(const Event &event);
+	void render();
+	void render(const Event &event, uint64_t &rendered);
+
+       public:
+	/**
+	 * @brief Start the renderer thread
+	 *
+	 * @param view View to render
+	 * @param policy What to do when the renderer is behind
+	 * @param out Stream the log is printed to, the one of the view
+	 */
+	explicit View_async(std::unique_ptr<View> view,
+			    Policy policy     = DROP_TO_LATEST,
+			    std::ostream &out = std::cout);
+	View_async(const View_async &)            = delete;
+	View_async(View_async &&)                 = delete;
+	View_async &operator=(const View_async &) = delete;
+	View_async &operator=(View_async &&)      = delete;
+	/**
+	 * @brief Render the events left, then stop the renderer thread
+	 */
+	~View_async() override;
+
+	void start_new_game(const Chessboard &chessboard) override;
+	void update(const Move_event &event,
+		    const Chessboard &chessboard) override;
+	void end(const Chessboard &chessboard) override;
+
+	/**
+	 * @brief Get the number of positions never rendered because a later
+	 * one replaced them
+	 *
+	 * @return uint64_t
+	 */
+	uint64_t get_dropped() const { return dropped; };
+	/**
+	 * @brief Get a stream for the game thread, printed by the renderer in
+	 * order with the boards at each flush
+	 *
+	 * @return std::ostream&
+	 */
+	std::ostream &get_log() { return log; };
+};
@@ -29,18 +29,19 @@ class View_demulti : public View {
 	View_demulti &operator=(const View_demulti &) = delete;
 	View_demulti &operator=(View_demulti &&)      = delete;
 
-	void start_new_game(Chessboard chessboard) override {
+	void start_new_game(const Chessboard &chessboard) override {
 		u->start_new_game(chessboard);
 		v->start_new_game(chessboard);
 	}
 
-	void update(Chessboard chessboard) override {
-		u->update(chessboard);
-		v->update(chessboard);
+	void update(const Move_event &event,
+		    const Chessboard &chessboard) override {
+		u->update(event, chessboard);
+		v->update(event, chessboard);
 	}
 
-	void end() override {
-		u->end();
-		v->end();
+	void end(const Chessboard &chessboard) override {
+		u->end(chessboard);
+		v->end(chessboard);
 	}
 };
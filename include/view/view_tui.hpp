@@ -1,16 +1,46 @@
 #pragma once
 
+#include <iostream>
+#include <string>
+
 #include "view/view.hpp"
 
 /**
- * @brief View that render the game in the terminal
+ * @brief View that render the game in the terminal. Each frame is built in
+ * one buffer and written at once.
  */
 class View_tui : public View {
+       public:
+	enum Mode {
+		// print the whole board after each move, under the previous one
+		SCROLL,
+		// draw the board once at the top of the terminal, then only the
+		// squares that changed, the rest of the output scrolls below it
+		DIFF,
+	};
+
        private:
-	Chessboard chessboard;
+	Mode mode;
+	std::ostream &out;
+	// squares on the screen and ply of their position, for DIFF
+	board::Board screen;
+	int ply = 0;
+	// frame being built, its memory is kept from one to the next
+	std::string frame;
+
+	void draw_board(const board::Board &board);
+	void draw_square(int line, int col, board::Colored_piece piece);
+	void redraw(const Chessboard &chessboard, board::Square square);
+	void write();
 
        public:
-	View_tui()                            = default;
+	/**
+	 * @brief Construct a new View_tui object
+	 *
+	 * @param mode How the board is redrawn after a move
+	 * @param out Stream of the terminal
+	 */
+	explicit View_tui(Mode mode = SCROLL, std::ostream &out = std::cout);
 	View_tui(const View_tui &)            = delete;
 	View_tui(View_tui &&)                 = delete;
 	View_tui &operator=(const View_tui &) = delete;
@@ -22,16 +52,20 @@ class View_tui : public View {
 	 *
 	 * @param chessboard Chessboard object
 	 */
-	void start_new_game(Chessboard chessboard) override;
+	void start_new_game(const Chessboard &chessboard) override;
 	/**
 	 * @brief Print the chessboard in the terminal
 	 *
+	 * @param event Move played, DIFF only redraws its squares unless an
+	 * update was skipped
 	 * @param chessboard Chessboard object
 	 */
-	void update(Chessboard chessboard) override;
+	void update(const Move_event &event,
+		    const Chessboard &chessboard) override;
 	/**
 	 * @brief Print the the final position and the score in the terminal
 	 *
+	 * @param chessboard Final position
 	 */
-	void end() override;
+	void end(const Chessboard &chessboard) override;
 };
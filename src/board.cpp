@@ -4,42 +4,44 @@
 
 using namespace board;
 
-Board from_pgn(const std::string& pgn) {
+Board board::from_string(const std::string& str) {
 	const std::string delimiter = ",";
 	Board board;
 
 	size_t offset = 0;
 	for (auto& line : board) {
 		for (auto& square : line) {
-			size_t pos = pgn.find(delimiter, offset);
+			size_t pos = str.find(delimiter, offset);
 			if (pos == std::string::npos)
 				throw std::invalid_argument(
 				    "PGN string must have 64 squares");
-			std::string token = pgn.substr(offset, pos);
-			offset += pos + delimiter.length();
-			square = Colored_piece(token);
+			std::string token = str.substr(offset, pos - offset);
+			offset            = pos + delimiter.length();
+			square            = Colored_piece(token);
 		}
 	}
-	if (offset != pgn.length()) {
+	if (offset != str.length()) {
 		throw std::invalid_argument("PGN string must have 64 squares");
 	}
 	return board;
 }
 
-std::string to_pgn(const Board& board) {
-	std::string pgn;
+std::string board::to_string(const Board& board) {
+	std::string str;
+	str.reserve(64 * 3);
 	for (const auto& line : board) {
 		for (const auto& square : line) {
-			pgn += square.to_string() + ",";
+			str += square.to_string() + ",";
 		}
 	}
-	return pgn;
+	return str;
 }
 
 Colored_piece::Colored_piece(std::string pgn) {
 	if (pgn.length() == 0) {
 		piece = NO_PIECE;
 		color = NO_COLOR;
+		return;
 	}
 	if (pgn.length() != 2) {
 		throw std::invalid_argument(
@@ -81,7 +83,7 @@ Colored_piece::Colored_piece(std::string pgn) {
 		    "or 'P'");
 	}
 }
-std::string Colored_piece::to_utf() const {
+const char* Colored_piece::to_utf_cstr() const {
 	const bool is_white = color == WHITE;
 
 	switch (piece) {
@@ -103,6 +105,7 @@ std::string Colored_piece::to_utf() const {
 		assert(false);
 	}
 }
+std::string Colored_piece::to_utf() const { return to_utf_cstr(); }
 std::string Colored_piece::to_string() const {
 	const bool is_white = color == WHITE;
 
@@ -1,43 +1,79 @@
 #include "controller/controller.hpp"
 
 #include "logic/chessboard.hpp"
+#include "notation/san.hpp"
 #include "player/player.hpp"
 
 void Controller::start() {
+	Run_loop loop;
+	Game_task task = play();
+	task.start(loop);
+	while (!task.is_done()) loop.run_one();
+	task.get();
+}
+
+Game_task Controller::play() {
+	begin();
+	while (chessboard.get_game_state() == ONGOING) {
+		Async_player &player = turn % 2 == 0 ? *white : *black;
+		Move_future answer   = is_invalid
+					   ? player.invalid_move(chessboard)
+					   : player.play(chessboard);
+		const Player_move player_move = co_await answer;
+		if (!apply(player_move)) break;
+		co_await Yield();
+	}
+	finish();
+}
+
+void Controller::begin() {
 	white->start_new_game(true);
 	black->start_new_game(false);
 	view->start_new_game(chessboard);
+	if (recorder) recorder->start_game();
 
-	int turn        = 0;
-	bool is_invalid = false;
-	while (chessboard.get_game_state() == ONGOING) {
-		auto player = turn % 2 == 0 ? white.get() : black.get();
-		Player_move player_move = is_invalid
-					      ? player->invalid_move(chessboard)
-					      : player->play(chessboard);
-
-		Action action = player_move.action;
-		if (action == PLAY) {
-			if (!chessboard.make_move(player_move.move)) {
-				is_invalid = true;
-				continue;
-			}
-			view->update(chessboard);
-			is_invalid = false;
-			turn++;
-
-		} else if (action == END) {
-			chessboard.set_game_state(ONGOING);
-			break;
-		} else if (action == DRAW) {
-			chessboard.set_game_state(STALEMATE);
-		} else if (action == RESIGN) {
-			chessboard.set_game_state(
-			    turn % 2 == 0 ? BLACK_CHECKMATE : WHITE_CHECKMATE);
+	turn       = chessboard.get_turn_count();
+	is_invalid = false;
+}
+
+// false when the player ends the game
+bool Controller::apply(const Player_move &player_move) {
+	Action action = player_move.action;
+	if (action == PLAY) {
+		// the notation depends on the position before the move
+		char san[notation::SAN_MAX_LENGTH];
+		size_t san_length = 0;
+		if (recorder) {
+			san_length = notation::format_san(
+			    chessboard, player_move.move, san);
 		}
+		if (!chessboard.make_move(player_move.move)) {
+			is_invalid = true;
+			return true;
+		}
+		if (recorder) recorder->add_move({san, san_length}, chessboard);
+		view->update({player_move.move, chessboard.get_last_capture(),
+			      chessboard.get_game_state(),
+			      chessboard.get_key()},
+			     chessboard);
+		is_invalid = false;
+		turn++;
+
+	} else if (action == END) {
+		chessboard.set_game_state(ONGOING);
+		return false;
+	} else if (action == DRAW) {
+		chessboard.set_game_state(STALEMATE);
+	} else if (action == RESIGN) {
+		chessboard.set_game_state(
+		    turn % 2 == 0 ? BLACK_CHECKMATE : WHITE_CHECKMATE);
 	}
+	return true;
+}
 
-	white->end();
-	black->end();
-	view->end();
+void Controller::finish() {
+	if (recorder) recorder->end_game(chessboard.get_game_state());
+	white->end(chessboard);
+	black->end(chessboard);
+	view->end(chessboard);
 }
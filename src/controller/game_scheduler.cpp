@@ -0,0 +1,90 @@
+#include "controller/game_scheduler.hpp"
+
+#include <algorithm>
+
+void Game_scheduler::post(std::coroutine_handle<> coroutine) {
+	const Clock::time_point queued = Clock::now();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue_depth++;
+		max_queue_depth = std::max(max_queue_depth, queue_depth);
+	}
+	pool.submit([this, coroutine, queued] {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			const Clock::duration latency = Clock::now() - queued;
+			queue_depth--;
+			executing++;
+			steps++;
+			total_latency += latency;
+			max_latency = std::max(max_latency, latency);
+		}
+		coroutine.resume();
+		std::lock_guard<std::mutex> lock(mutex);
+		executing--;
+		if (games.empty() && executing == 0) all_finished.notify_all();
+	});
+}
+
+size_t Game_scheduler::add(std::unique_ptr<Controller> controller) {
+	Game_task task = controller->play();
+	size_t id;
+	Game *game;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		id   = next_id++;
+		game = &games
+			    .emplace(id, Game{std::move(controller),
+					      std::move(task), Clock::now()})
+			    .first->second;
+	}
+	// the game can't end before it starts, the reference stays valid
+	game->task.start(*this, [this, id] { finish(id); });
+	return id;
+}
+
+void Game_scheduler::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	all_finished.wait(lock,
+			  [this] { return games.empty() && executing == 0; });
+	if (error) {
+		std::exception_ptr first = error;
+		error                    = nullptr;
+		std::rethrow_exception(first);
+	}
+}
+
+Scheduler_stats Game_scheduler::get_stats() {
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+	std::lock_guard<std::mutex> lock(mutex);
+	Scheduler_stats stats;
+	// a worker can still be returning from the last step of a game
+	const size_t busy     = std::min(games.size(), queue_depth + executing);
+	stats.running         = busy;
+	stats.waiting         = games.size() - busy;
+	stats.finished        = finished;
+	stats.queue_depth     = queue_depth;
+	stats.max_queue_depth = max_queue_depth;
+	stats.steps           = steps;
+	stats.mean_latency_ms =
+	    steps ? Milliseconds(total_latency).count() / steps : 0;
+	stats.max_latency_ms = Milliseconds(max_latency).count();
+	stats.mean_game_ms =
+	    finished ? Milliseconds(total_game).count() / finished : 0;
+	return stats;
+}
+
+// called by the game from its last suspension point
+void Game_scheduler::finish(size_t id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Game &game = games.at(id);
+	finished++;
+	total_game += Clock::now() - game.started;
+	try {
+		game.task.get();
+		if (on_finished) on_finished(id, *game.controller);
+	} catch (...) {
+		if (!error) error = std::current_exception();
+	}
+	games.erase(id);
+}
@@ -1,8 +1,13 @@
 #include "logic/chessboard.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 #include <vector>
 
+#include "logic/zobrist.hpp"
+#include "utils/cpu.hpp"
+
 using namespace logic;
 
 Square convert(board::Square square) {
@@ -93,29 +98,116 @@ constexpr board::Color convert(Color color) {
 //   '----'----'----'----'----'----'----'----'
 //   }}}
 
+// a mailbox entry holds the piece in its low bits and the color above
+constexpr uint8_t encode(Piece piece, Color color) {
+	return uint8_t(color << 3 | piece);
+}
+
 Chessboard::Chessboard(const board::Board &board) {
 	for (auto &bitboard : pieces) bitboard = BOARD_CLEAR;
 	for (auto &bitboard : color) bitboard = BOARD_CLEAR;
+	std::fill(mailbox, mailbox + 64, encode(PIECE_NONE, COLOR_NONE));
+	key = 0;
 
 	int i = 0;
 	for (auto &line : board) {
 		for (auto &square : line) {
-			if (square.piece != board::NO_PIECE) {
-				pieces[convert(square.piece)] |= (Bitboard)1
-								 << i;
-				color[convert(square.color)] |= (Bitboard)1
-								<< i;
+			const Piece piece = convert(square.piece);
+			const Color c     = convert(square.color);
+			if (piece != PIECE_NONE && c != COLOR_NONE) {
+				pieces[piece] |= bb_of(Square(i));
+				color[c] |= bb_of(Square(i));
+				set_square(Square(i), piece, c);
 			}
 			i++;
 		}
 	}
 
-	turn_count = 0;
-	castling   = ALL;
-	enpassant  = SQ_NONE;
+	turn_count     = 0;
+	halfmove_clock = 0;
+	castling       = initial_castling();
+	enpassant      = SQ_NONE;
+	key ^= zobrist::keys.castling[castling];
+	compute_all_attacks();
 	compute_legal<WHITE>();
 }
 
+Chessboard::Chessboard(const Position &position) {
+	std::copy(position.color, position.color + 2, color);
+	std::copy(position.pieces, position.pieces + 6, pieces);
+	if (popcount(pieces[KING] & color[WHITE]) != 1 ||
+	    popcount(pieces[KING] & color[BLACK]) != 1) {
+		throw std::invalid_argument("Each side needs exactly one king");
+	}
+	std::fill(mailbox, mailbox + 64, encode(PIECE_NONE, COLOR_NONE));
+	for (int i = SQ_A1; i <= SQ_H8; i++) {
+		const Bitboard square = bb_of(Square(i));
+		for (int p = PAWN; p <= KING; p++) {
+			if (!(pieces[p] & square)) continue;
+			const Color c = color[WHITE] & square ? WHITE : BLACK;
+			mailbox[i]    = encode(Piece(p), c);
+		}
+	}
+
+	turn_count     = position.turn;
+	halfmove_clock = position.halfmove_clock;
+	castling       = Castling(position.castling);
+	enpassant      = Square(position.enpassant);
+	key            = compute_key();
+	compute_all_attacks();
+	if (turn_count % 2 == WHITE) {
+		compute_legal<WHITE>();
+	} else {
+		compute_legal<BLACK>();
+	}
+}
+
+Position Chessboard::get_position() const {
+	Position position;
+	std::copy(color, color + 2, position.color);
+	std::copy(pieces, pieces + 6, position.pieces);
+	position.key       = key;
+	position.enpassant = uint8_t(enpassant);
+	position.turn      = uint8_t(turn_count % 2);
+	position.castling  = uint8_t(castling);
+	position.halfmove_clock =
+	    uint8_t(halfmove_clock < 255 ? halfmove_clock : 255);
+	return position;
+}
+
+uint64_t Chessboard::compute_key() const {
+	uint64_t computed = zobrist::keys.castling[castling];
+	for (int i = SQ_A1; i <= SQ_H8; i++) {
+		const Square square = Square(i);
+		if (get_piece(square) == PIECE_NONE) continue;
+		computed ^= zobrist::keys.pieces[get_color(square)]
+						[get_piece(square)][square];
+	}
+	if (enpassant != SQ_NONE) {
+		computed ^= zobrist::keys.enpassant[col_of(enpassant)];
+	}
+	if (turn_count % 2 == BLACK) computed ^= zobrist::keys.side;
+	return computed;
+}
+
+// rights of a custom board, only kept when the king and the rook stand on
+// their initial squares
+Castling Chessboard::initial_castling() const {
+	auto is_at = [this](Square square, Piece piece, Color c) {
+		return get_piece(square) == piece && get_color(square) == c;
+	};
+	int rights = 0;
+	if (is_at(SQ_E1, KING, WHITE)) {
+		if (is_at(SQ_H1, ROOK, WHITE)) rights |= WHITE_OO;
+		if (is_at(SQ_A1, ROOK, WHITE)) rights |= WHITE_OOO;
+	}
+	if (is_at(SQ_E8, KING, BLACK)) {
+		if (is_at(SQ_H8, ROOK, BLACK)) rights |= BLACK_OO;
+		if (is_at(SQ_A8, ROOK, BLACK)) rights |= BLACK_OOO;
+	}
+	return Castling(rights);
+}
+
 constexpr Color enemy(Color color) {
 	switch (color) {
 	case WHITE:
@@ -128,7 +220,8 @@ constexpr Color enemy(Color color) {
 }
 
 bool Chessboard::is_same_as(const Chessboard &chessboard) const {
-	return color[WHITE] == chessboard.color[WHITE] &&
+	return key == chessboard.key &&
+	       color[WHITE] == chessboard.color[WHITE] &&
 	       color[BLACK] == chessboard.color[BLACK] &&
 	       pieces[PAWN] == chessboard.pieces[PAWN] &&
 	       pieces[ROOK] == chessboard.pieces[ROOK] &&
@@ -145,41 +238,36 @@ bool Chessboard::is_attacked(board::Square bsquare) const {
 	return attacks & bb_of(square);
 }
 
-template <Color c>
-inline void Chessboard::fill_array(board::Board &board) const {
-	auto pieces_c = color[c];
-	while (pieces_c) {
-		auto square = pop_lsb(pieces_c);
-
-		board[square / 8][square % 8].color = convert(c);
-	}
-}
-
-template <Piece p>
-inline void Chessboard::fill_array(board::Board &board) const {
-	auto pieces_p = pieces[p];
-	while (pieces_p) {
-		auto square = pop_lsb(pieces_p);
-
-		board[square / 8][square % 8].piece = convert(p);
-	}
-}
-
 board::Board Chessboard::to_array() const {
 	board::Board board;
 
-	fill_array<PAWN>(board);
-	fill_array<ROOK>(board);
-	fill_array<KNIGHT>(board);
-	fill_array<BISHOP>(board);
-	fill_array<QUEEN>(board);
-	fill_array<KING>(board);
-	fill_array<WHITE>(board);
-	fill_array<BLACK>(board);
+	for (int i = SQ_A1; i <= SQ_H8; i++) {
+		const Square square = Square(i);
+		board[i / 8][i % 8] = board::Colored_piece(
+		    convert(get_piece(square)), convert(get_color(square)));
+	}
 
 	return board;
 }
 
+std::string_view to_string(GameState state) {
+	switch (state) {
+	case ONGOING:
+		return "?-?";
+	case WHITE_CHECKMATE:
+		return "1-0";
+	case BLACK_CHECKMATE:
+		return "0-1";
+	case STALEMATE:
+	case REPETITION:
+	case FIFTY_MOVES:
+	case INSUFFICIENT_MATERIAL:
+		return "1/2-1/2";
+	default:
+		throw std::invalid_argument("Incorrect GameState");
+	}
+}
+
 void Chessboard::set_game_state(GameState game_state) {
 	GameState real_state = get_game_state();
 	if (real_state == ONGOING) {
@@ -193,16 +281,30 @@ GameState Chessboard::get_game_state() const {
 	if (game_state != ONGOING) return game_state;
 
 	if (legal_move_count == 0) {
-		if (check_count > 0) {
+		if (checkers) {
 			return (turn_count % 2 == WHITE ? BLACK_CHECKMATE
 							: WHITE_CHECKMATE);
 		} else {
 			return STALEMATE;
 		}
 	}
+	// a checkmate on the last move still wins, so the draws come after
+	if (halfmove_clock >= 100) return FIFTY_MOVES;
+	if (is_insufficient_material()) return INSUFFICIENT_MATERIAL;
+	// only positions since the last irreversible move can repeat
+	if (halfmove_clock >= 4 && history.count(key) >= 2) return REPETITION;
 	return ONGOING;
 }
 
+bool Chessboard::is_insufficient_material() const {
+	if (pieces[PAWN] | pieces[ROOK] | pieces[QUEEN]) return false;
+	const Bitboard minors = pieces[KNIGHT] | pieces[BISHOP];
+	if (popcount(minors) <= 1) return true;
+	// bishops all on the same color never attack the other squares
+	return !pieces[KNIGHT] && (!(minors & LIGHT_SQUARES) ||
+				   !(minors & ~LIGHT_SQUARES));
+}
+
 board::Colored_piece Chessboard::get_piece(board::Square square) const {
 	return board::Colored_piece(convert(get_piece(convert(square))),
 				    convert(get_color(convert(square))));
@@ -259,19 +361,21 @@ std::vector<board::Move> Chessboard::get_all_legal_moves() const {
 }
 
 Piece Chessboard::get_piece(Square square) const {
-	if (pieces[PAWN] & bb_of(square)) return PAWN;
-	if (pieces[ROOK] & bb_of(square)) return ROOK;
-	if (pieces[KNIGHT] & bb_of(square)) return KNIGHT;
-	if (pieces[BISHOP] & bb_of(square)) return BISHOP;
-	if (pieces[QUEEN] & bb_of(square)) return QUEEN;
-	if (pieces[KING] & bb_of(square)) return KING;
-	return PIECE_NONE;
+	return Piece(mailbox[square] & 0x7);
 }
 
 Color Chessboard::get_color(Square square) const {
-	if (color[WHITE] & bb_of(square)) return WHITE;
-	if (color[BLACK] & bb_of(square)) return BLACK;
-	return COLOR_NONE;
+	return Color(mailbox[square] >> 3);
+}
+
+inline void Chessboard::set_square(Square square, Piece piece, Color c) {
+	const Piece previous = get_piece(square);
+	const Color owner    = get_color(square);
+	if (previous != PIECE_NONE) {
+		key ^= zobrist::keys.pieces[owner][previous][square];
+	}
+	if (piece != PIECE_NONE) key ^= zobrist::keys.pieces[c][piece][square];
+	mailbox[square] = encode(piece, c);
 }
 
 template <Color c>
@@ -285,169 +389,119 @@ inline bool Chessboard::can_castle() const {
 	       (s == QUEENSIDE ? QUEENSIDE_CASTLE : KINGSIDE_CASTLE);
 }
 
-template <Color c>
-inline void Chessboard::compute_pawn_attack(Square square) {
-	constexpr int dir = c == WHITE ? -1 : 1;
-
-	const Bitboard pawn = bb_of(square);
-	const Line line     = line_of(square);
-	const Bitboard king = pieces[KING] & color[c];
-
-	Bitboard attack = bb_of(static_cast<Square>(square + dir * 7)) |
-			  bb_of(static_cast<Square>(square + dir * 9));
-
-	attack &= bb_of(static_cast<Line>(line + dir));
-
-	threat |= bool(attack & king) * pawn;
-	check_count += bool(attack & king);
-
-	attacks |= attack;
-}
-
-template <Direction d, Color c>
-inline void Chessboard::compute_ray_attack(Square square) {
-	const Bitboard piece     = bb_of(square);
-	const Bitboard king      = pieces[KING] & color[c];
-	const Bitboard obstacles = (color[WHITE] | color[BLACK]) & ~piece;
-
-	Bitboard attack = ray_between<d>(square, obstacles);
-
-	threat |= bool(attack & king) * attack;
-	check_count += bool(attack & king);
-
-	attacks |= attack & ~piece;
-}
-
-template <Color c>
-inline void Chessboard::compute_rook_attack(Square square) {
-	compute_ray_attack<NORTH, c>(square);
-	compute_ray_attack<SOUTH, c>(square);
-	compute_ray_attack<EAST, c>(square);
-	compute_ray_attack<WEST, c>(square);
+template <Piece p>
+constexpr Bitboard attacks_of(Square square, Bitboard obstacles) {
+	switch (p) {
+	case KNIGHT:
+		return KNIGHT_ATTACKS[square];
+	case BISHOP:
+		return bishop_attacks(square, obstacles);
+	case ROOK:
+		return rook_attacks(square, obstacles);
+	case QUEEN:
+		return bishop_attacks(square, obstacles) |
+		       rook_attacks(square, obstacles);
+	default:
+		assert(false);
+	}
 }
 
-template <Color c>
-inline void Chessboard::compute_bishop_attack(Square square) {
-	compute_ray_attack<NORTH_EAST, c>(square);
-	compute_ray_attack<NORTH_WEST, c>(square);
-	compute_ray_attack<SOUTH_EAST, c>(square);
-	compute_ray_attack<SOUTH_WEST, c>(square);
-}
+// rays go through the enemy king, it can't step back along them
+inline Bitboard Chessboard::compute_piece_attack(Square square) const {
+	const Piece piece = get_piece(square);
+	if (piece == PIECE_NONE) return BOARD_CLEAR;
 
-template <Color c>
-inline void Chessboard::compute_queen_attack(Square square) {
-	compute_bishop_attack<c>(square);
-	compute_rook_attack<c>(square);
-}
+	const Color c            = get_color(square);
+	const Bitboard king      = pieces[KING] & color[enemy(c)];
+	const Bitboard obstacles = (color[WHITE] | color[BLACK]) & ~king;
 
-template <Piece p, Color c>
-inline void Chessboard::compute_attack(Square square) {
-	switch (p) {
+	switch (piece) {
 	case PAWN:
-		return compute_pawn_attack<c>(square);
+		return PAWN_ATTACKS[c][square];
 	case KNIGHT:
-		return compute_knight_attack<c>(square);
+		return attacks_of<KNIGHT>(square, obstacles);
 	case BISHOP:
-		return compute_bishop_attack<c>(square);
+		return attacks_of<BISHOP>(square, obstacles);
 	case ROOK:
-		return compute_rook_attack<c>(square);
+		return attacks_of<ROOK>(square, obstacles);
 	case QUEEN:
-		return compute_queen_attack<c>(square);
+		return attacks_of<QUEEN>(square, obstacles);
 	case KING:
-		return compute_king_attack(square);
+		return KING_ATTACKS[square];
+	default:
+		return BOARD_CLEAR;
 	}
 }
 
-template <Piece p, Color c>
-inline void Chessboard::compute_pieces_attack() {
-	Bitboard remaining = pieces[p] & color[enemy(c)];
-	while (remaining) {
-		const Square piece = static_cast<Square>(pop_lsb(remaining));
-		compute_attack<p, c>(piece);
+void Chessboard::compute_all_attacks() {
+	for (int i = SQ_A1; i <= SQ_H8; i++) {
+		piece_attacks[i] = compute_piece_attack(Square(i));
 	}
 }
 
-template <Color c>
-inline void Chessboard::compute_knight_attack(Square square) {
-	const Bitboard king = pieces[KING] & color[c];
-	const Line line     = line_of(square);
-	const Column column = col_of(square);
-
-	const Bitboard line_inner =
-	    bounded_bb_of(Line(line - 1)) | bounded_bb_of(Line(line + 1));
-	const Bitboard line_outer =
-	    bounded_bb_of(Line(line - 2)) | bounded_bb_of(Line(line + 2));
-	const Bitboard col_inner = bounded_bb_of(Column(column - 1)) |
-				   bounded_bb_of(Column(column + 1));
-	const Bitboard col_outer = bounded_bb_of(Column(column - 2)) |
-				   bounded_bb_of(Column(column + 2));
-
-	const Bitboard attack =
-	    (line_inner & col_outer) | (line_outer & col_inner);
-
-	threat |= bb_of(square) * bool(attack & king);
-	check_count += bool(attack & pieces[KING] & color[c]);
-
-	attacks |= attack;
-}
-
-inline void Chessboard::compute_king_attack(Square square) {
-	const Line line     = line_of(square);
-	const Column column = col_of(square);
-
-	const Bitboard lines = bounded_bb_of(static_cast<Line>(line - 1)) |
-			       bb_of(static_cast<Line>(line)) |
-			       bounded_bb_of(static_cast<Line>(line + 1));
-	const Bitboard columns =
-	    bounded_bb_of(static_cast<Column>(column - 1)) |
-	    bb_of(static_cast<Column>(column)) |
-	    bounded_bb_of(static_cast<Column>(column + 1));
+inline void Chessboard::update_attacks(Bitboard changed) {
+	// a slider sees every square its ray reaches, so the ones seeing a
+	// changed square are the only ones whose rays may have moved
+	const Bitboard sliders = pieces[BISHOP] | pieces[ROOK] | pieces[QUEEN];
+	Bitboard stale         = changed;
+	Bitboard remaining     = sliders & ~changed;
+	while (remaining) {
+		const Square slider = static_cast<Square>(pop_lsb(remaining));
+		if (piece_attacks[slider] & changed) stale |= bb_of(slider);
+	}
+	while (stale) {
+		const Square square    = static_cast<Square>(pop_lsb(stale));
+		piece_attacks[square] = compute_piece_attack(square);
+	}
 
-	attacks |= (lines & columns) & ~bb_of(square);
+#ifdef CHECK_ATTACKS
+	Bitboard incremental[64];
+	std::copy(piece_attacks, piece_attacks + 64, incremental);
+	compute_all_attacks();
+	if (!std::equal(piece_attacks, piece_attacks + 64, incremental)) {
+		throw std::logic_error(
+		    "Incremental attacks differ from a full recompute");
+	}
+#endif
 }
 
 template <Color c>
 inline void Chessboard::compute_attacks() {
-	attacks     = BOARD_CLEAR;
-	threat      = BOARD_CLEAR;
-	check_count = 0;
+	constexpr Direction down = c == WHITE ? SOUTH : NORTH;
+	const Bitboard pawns     = pieces[PAWN] & color[enemy(c)];
 
-	compute_pieces_attack<PAWN, c>();
-	compute_pieces_attack<ROOK, c>();
-	compute_pieces_attack<KNIGHT, c>();
-	compute_pieces_attack<BISHOP, c>();
-	compute_pieces_attack<QUEEN, c>();
+	// pawns are cheaper to do all at once than one by one
+	attacks = shift<EAST>(shift<down>(pawns)) |
+		  shift<WEST>(shift<down>(pawns));
 
-	const Square enemy_king = Square(lsb(pieces[KING] & color[enemy(c)]));
-	compute_king_attack(enemy_king);
+	Bitboard remaining = color[enemy(c)] & ~pieces[PAWN];
+	while (remaining) attacks |= piece_attacks[pop_lsb(remaining)];
 }
 
-template <Color c>
-constexpr bool isOnLine2(Square square) {
-	if (c == BLACK)
-		return square >= 48;
-	else
-		return square < 16;
+// the pawn of each target square stands offset squares behind it
+template <int offset>
+inline void Chessboard::add_pawn_moves(Bitboard targets) {
+	while (targets) {
+		const Square to = static_cast<Square>(pop_lsb(targets));
+		legal_moves[to - offset] |= bb_of(to);
+	}
 }
 
 template <Color c>
-inline void Chessboard::compute_pawn_moves(Square square) {
-	constexpr int dir         = c == WHITE ? 1 : -1;
-	const Bitboard all_pieces = color[WHITE] | color[BLACK];
-	const Line line           = line_of(square);
-
-	Bitboard attack_moves = BOARD_CLEAR;
-	attack_moves |= bb_of(Square(square + dir * 7));
-	attack_moves |= bb_of(Square(square + dir * 9));
-	attack_moves &= bb_of(Line(line + dir)) & color[enemy(c)];
+inline void Chessboard::compute_pawns_moves() {
+	constexpr Direction up   = c == WHITE ? NORTH : SOUTH;
+	constexpr Direction east = c == WHITE ? NORTH_EAST : SOUTH_EAST;
+	constexpr Direction west = c == WHITE ? NORTH_WEST : SOUTH_WEST;
+	constexpr Bitboard third_line = bb_of(c == WHITE ? LINE_3 : LINE_6);
 
-	Bitboard push_moves = BOARD_CLEAR;
-	push_moves |= bb_of(Square(square + dir * 8));
-	push_moves |= bb_of(Square(square + dir * 16)) * isOnLine2<c>(square) *
-		      !(bb_of(Square(square + dir * 8)) & all_pieces);
-	push_moves &= ~all_pieces;
+	const Bitboard pawns = pieces[PAWN] & color[c];
+	const Bitboard empty = ~(color[WHITE] | color[BLACK]);
 
-	legal_moves[square] |= attack_moves | push_moves;
+	const Bitboard single = shift<up>(pawns) & empty;
+	add_pawn_moves<step(up)>(single);
+	add_pawn_moves<2 * step(up)>(shift<up>(single & third_line) & empty);
+	add_pawn_moves<step(east)>(shift<east>(pawns) & color[enemy(c)]);
+	add_pawn_moves<step(west)>(shift<west>(pawns) & color[enemy(c)]);
 }
 
 template <Direction d, Color c>
@@ -484,43 +538,17 @@ inline void Chessboard::compute_queen_moves(Square square) {
 
 template <Color c>
 inline void Chessboard::compute_knight_moves(Square square) {
-	const Bitboard allies = color[c];
-	const Line line       = line_of(square);
-	const Column column   = col_of(square);
-
-	const Bitboard line_inner =
-	    bounded_bb_of(Line(line - 1)) | bounded_bb_of(Line(line + 1));
-	const Bitboard line_outer =
-	    bounded_bb_of(Line(line - 2)) | bounded_bb_of(Line(line + 2));
-	const Bitboard col_inner = bounded_bb_of(Column(column - 1)) |
-				   bounded_bb_of(Column(column + 1));
-	const Bitboard col_outer = bounded_bb_of(Column(column - 2)) |
-				   bounded_bb_of(Column(column + 2));
-
-	legal_moves[square] |=
-	    ((line_inner & col_outer) | (line_outer & col_inner)) & ~allies;
+	legal_moves[square] |= KNIGHT_ATTACKS[square] & ~color[c];
 }
 
 template <Color c>
 inline void Chessboard::compute_king_moves(Square square) {
-	const Bitboard allies = color[c];
-
-	const Line line     = line_of(square);
-	const Column column = col_of(square);
-
-	const Bitboard lines = bounded_bb_of(Line(line - 1)) |
-			       bb_of(Line(line)) |
-			       bounded_bb_of(Line(line + 1));
-	const Bitboard columns = bounded_bb_of(Column(column - 1)) |
-				 bb_of(Column(column)) |
-				 bounded_bb_of(Column(column + 1));
-
-	legal_moves[square] |= (lines & columns) & ~allies & ~attacks;
+	legal_moves[square] |= KING_ATTACKS[square] & ~color[c] & ~attacks;
 }
 
 template <Color c>
 inline void Chessboard::compute_castling() {
-	if (!can_castle<c>() || check_count > 0) return;
+	if (!can_castle<c>() || checkers) return;
 	constexpr Square king_square = c == WHITE ? SQ_E1 : SQ_E8;
 
 	constexpr Bitboard king_side =  //
@@ -599,12 +627,12 @@ inline void Chessboard::compute_enpassant() {
 	    (pieces[QUEEN] | pieces[ROOK]) & color[enemy(c)];
 
 	const Square right = is_pawn_right ? Square(enpassant + 1) : enpassant;
-	const Square left  = is_pawn_right ? enpassant : Square(enpassant + 1);
+	const Square left  = is_pawn_right ? enpassant : Square(enpassant - 1);
 
 	const auto offset = is_pawn_right ? 1 : -1;
 
-	const Bitboard collision_right = ray_between<EAST>(right, all_pieces);
-	const Bitboard collision_left  = ray_between<WEST>(left, all_pieces);
+	const Bitboard collision_right = ray_attack<EAST>(right, all_pieces);
+	const Bitboard collision_left  = ray_attack<WEST>(left, all_pieces);
 
 	if ((collision_left & king) && (collision_right & sliders)) return;
 	if ((collision_left & sliders) && (collision_right & king)) return;
@@ -615,8 +643,6 @@ inline void Chessboard::compute_enpassant() {
 template <Piece p, Color c>
 constexpr void Chessboard::compute_piece_moves(Square square) {
 	switch (p) {
-	case PAWN:
-		return compute_pawn_moves<c>(square);
 	case ROOK:
 		return compute_rook_moves<c>(square);
 	case BISHOP:
@@ -641,68 +667,130 @@ inline void Chessboard::compute_pieces_moves() {
 	}
 }
 
-template <Color c, Direction d>
-inline void Chessboard::compute_pin() {
-	constexpr bool is_diag = d == NORTH_EAST || d == NORTH_WEST ||
-				 d == SOUTH_EAST || d == SOUTH_WEST;
-
-	const Bitboard king     = pieces[KING] & color[c];
-	const Bitboard ray_king = ray<d>(Square(lsb(king)));
+template <Color c>
+inline void Chessboard::compute_checkers() {
+	const Square king       = Square(lsb(pieces[KING] & color[c]));
 	const Bitboard enemies  = color[enemy(c)];
-	const Bitboard allies   = color[c] & ~king;
-	const Square enemy      = Square(collision<d>(ray_king, enemies));
-	Bitboard sliders =
-	    (pieces[QUEEN] | (is_diag ? pieces[BISHOP] : pieces[ROOK])) &
-	    enemies;
-	if (!(bb_of(enemy) & sliders)) return;
+	const Bitboard occupied = color[WHITE] | color[BLACK];
+	const Bitboard straight = (pieces[ROOK] | pieces[QUEEN]) & enemies;
+	const Bitboard diagonal = (pieces[BISHOP] | pieces[QUEEN]) & enemies;
+
+	checkers = ((KNIGHT_ATTACKS[king] & pieces[KNIGHT]) |
+		    (PAWN_ATTACKS[c][king] & pieces[PAWN])) &
+		   enemies;
+	pinned = BOARD_CLEAR;
+
+	// sliders aligned with the king give check when nothing stands
+	// between, and pin the piece when it is a lone ally
+	Bitboard snipers =
+	    (ROOK_RAYS[king] & straight) | (BISHOP_RAYS[king] & diagonal);
+	while (snipers) {
+		const Square sniper     = static_cast<Square>(pop_lsb(snipers));
+		const Bitboard blockers = BETWEEN[king][sniper] & occupied;
+		if (!blockers) {
+			checkers |= bb_of(sniper);
+		} else if (popcount(blockers) == 1 && (blockers & color[c])) {
+			pinned |= blockers;
+		}
+	}
+}
 
-	const Bitboard ray_enemy = ray<opposite(d)>(enemy);
-	const Square first_encounter =
-	    Square(collision<d>(ray_king, allies & ~king));
-	const Square last_encounter =
-	    Square(collision<opposite(d)>(ray_enemy, allies));
+template <Color c>
+inline void Chessboard::compute_pins() {
+	const Square king = Square(lsb(pieces[KING] & color[c]));
+	Bitboard remaining = pinned;
+	while (remaining) {
+		const Square piece = static_cast<Square>(pop_lsb(remaining));
+		legal_moves[piece] &= LINE[king][piece];
+	}
+}
 
-	if (first_encounter == last_encounter) {
-		legal_moves[first_encounter] &= ray_enemy;
+template <Piece p, Color c>
+inline void Chessboard::compute_pieces_evasions(Bitboard target) {
+	const Bitboard obstacles = color[WHITE] | color[BLACK];
+	// a pinned piece stays on its line through the king, it can't block
+	// or take a checker on another line
+	Bitboard remaining = pieces[p] & color[c] & ~pinned;
+	while (remaining) {
+		const Square piece  = static_cast<Square>(pop_lsb(remaining));
+		legal_moves[piece] = attacks_of<p>(piece, obstacles) & target;
 	}
 }
 
 template <Color c>
-inline void Chessboard::compute_pins() {
-	compute_pin<c, NORTH>();
-	compute_pin<c, SOUTH>();
-	compute_pin<c, EAST>();
-	compute_pin<c, WEST>();
-	compute_pin<c, NORTH_EAST>();
-	compute_pin<c, NORTH_WEST>();
-	compute_pin<c, SOUTH_EAST>();
-	compute_pin<c, SOUTH_WEST>();
+inline void Chessboard::compute_pawns_evasions(Bitboard target) {
+	constexpr Direction up   = c == WHITE ? NORTH : SOUTH;
+	constexpr Direction east = c == WHITE ? NORTH_EAST : SOUTH_EAST;
+	constexpr Direction west = c == WHITE ? NORTH_WEST : SOUTH_WEST;
+	constexpr Bitboard third_line = bb_of(c == WHITE ? LINE_3 : LINE_6);
+
+	const Bitboard pawns = pieces[PAWN] & color[c] & ~pinned;
+	const Bitboard empty = ~(color[WHITE] | color[BLACK]);
+
+	const Bitboard single = shift<up>(pawns) & empty;
+	add_pawn_moves<step(up)>(single & target);
+	add_pawn_moves<2 * step(up)>(shift<up>(single & third_line) & empty &
+				      target);
+	add_pawn_moves<step(east)>(shift<east>(pawns) & checkers);
+	add_pawn_moves<step(west)>(shift<west>(pawns) & checkers);
+
+	// taking en passant removes a checking pawn, or blocks a check
+	// discovered by its double push
+	if (enpassant == SQ_NONE) return;
+	const Bitboard landing = bb_of(Square(enpassant + step(up)));
+	if ((checkers & bb_of(enpassant)) || (target & landing)) {
+		compute_enpassant<c>();
+		Bitboard remaining = pinned & pieces[PAWN];
+		while (remaining) legal_moves[pop_lsb(remaining)] = BOARD_CLEAR;
+	}
+}
+
+template <Color c>
+inline void Chessboard::compute_evasions() {
+	compute_pieces_moves<KING, c>();
+	if (popcount(checkers) > 1) return;
+
+	const Square king     = Square(lsb(pieces[KING] & color[c]));
+	const Bitboard target = checkers | BETWEEN[king][lsb(checkers)];
+	compute_pawns_evasions<c>(target);
+	compute_pieces_evasions<KNIGHT, c>(target);
+	compute_pieces_evasions<BISHOP, c>(target);
+	compute_pieces_evasions<ROOK, c>(target);
+	compute_pieces_evasions<QUEEN, c>(target);
 }
 
 template <Color c>
 inline void Chessboard::compute_moves() {
 	std::fill(legal_moves, legal_moves + 64, BOARD_CLEAR);
-	if (check_count < 2) {
-		compute_pieces_moves<PAWN, c>();
-		compute_pieces_moves<BISHOP, c>();
-		compute_pieces_moves<ROOK, c>();
-		compute_pieces_moves<QUEEN, c>();
-		compute_pieces_moves<KNIGHT, c>();
-		compute_enpassant<c>();
-		compute_pins<c>();
-		if (check_count == 1) {
-			for (auto &moves : legal_moves) {
-				moves &= threat;
-			}
-		}
-	}
+	if (checkers) return compute_evasions<c>();
+
+	compute_pawns_moves<c>();
+	compute_pieces_moves<BISHOP, c>();
+	compute_pieces_moves<ROOK, c>();
+	compute_pieces_moves<QUEEN, c>();
+	compute_pieces_moves<KNIGHT, c>();
+	compute_enpassant<c>();
+	compute_pins<c>();
 	compute_pieces_moves<KING, c>();
 	compute_castling<c>();
 }
 
 template <Color c>
 inline void Chessboard::compute_legal() {
+	if (cache) {
+		if (const Move_set *set = cache->find(key)) {
+			std::copy(set->legal_moves, set->legal_moves + 64,
+				  legal_moves);
+			attacks          = set->attacks;
+			checkers         = set->checkers;
+			pinned           = set->pinned;
+			legal_move_count = set->legal_move_count;
+			return;
+		}
+	}
+
 	compute_attacks<c>();
+	compute_checkers<c>();
 	compute_moves<c>();
 
 	legal_move_count = 0;
@@ -719,28 +807,40 @@ inline void Chessboard::compute_legal() {
 		// add promotions, we add only 3 because one is already counted
 		legal_move_count += 3 * popcount(pawn_moves & last_line);
 	}
+
+	if (cache) {
+		Move_set &set = cache->slot(key);
+		set.key       = key;
+		std::copy(legal_moves, legal_moves + 64, set.legal_moves);
+		set.attacks          = attacks;
+		set.checkers         = checkers;
+		set.pinned           = pinned;
+		set.legal_move_count = legal_move_count;
+	}
 }
 
 inline void Chessboard::update_castle(Square rook) {
 	switch (rook) {
 	case SQ_A1:
-		castling = Castling(castling & WHITE_OO);
+		castling = Castling(castling & ~WHITE_OOO);
 		break;
 	case SQ_A8:
-		castling = Castling(castling & WHITE_OOO);
+		castling = Castling(castling & ~BLACK_OOO);
 		break;
 	case SQ_H1:
-		castling = Castling(castling & BLACK_OO);
+		castling = Castling(castling & ~WHITE_OO);
 		break;
 	case SQ_H8:
-		castling = Castling(castling & BLACK_OOO);
+		castling = Castling(castling & ~BLACK_OO);
 		break;
 	default:
 		break;
 	}
 }
 
-bool Chessboard::make_move(board::Move move) {
+// most of the move generation is inlined here, make it use the bit
+// manipulation instructions of the CPU
+CPU_DISPATCH bool Chessboard::make_move(board::Move move) {
 	Piece promotion = convert(move.promotion);
 	Square from     = convert(move.from);
 	Square to       = convert(move.to);
@@ -751,12 +851,19 @@ bool Chessboard::make_move(board::Move move) {
 	Piece new_piece = piece;
 	Piece captured  = get_piece(to);
 
+	const Castling old_castling = castling;
+	const Square old_enpassant  = enpassant;
+	const uint64_t old_key      = key;
+	Bitboard changed            = bb_of(from) | bb_of(to);
+
 	if (piece == PAWN) {
 		auto dir = c == WHITE ? 1 : -1;
 		if (to == enpassant + dir * 8) {
 			captured = PAWN;
+			changed |= bb_of(enpassant);
 			color[enemy(c)] &= ~bb_of(enpassant);
 			pieces[PAWN] &= ~bb_of(enpassant);
+			set_square(enpassant, PIECE_NONE, COLOR_NONE);
 		} else if ((c == WHITE && is_on_line<LINE_8>(to)) ||
 			   (c == BLACK && is_on_line<LINE_1>(to))) {
 			switch (promotion) {
@@ -781,10 +888,13 @@ bool Chessboard::make_move(board::Move move) {
 			    Square(to > from ? from + 3 : from - 4);
 			Square rook_to =
 			    Square(to > from ? from + 1 : from - 1);
+			changed |= bb_of(rook_from) | bb_of(rook_to);
 			pieces[ROOK] &= ~bb_of(rook_from);
 			pieces[ROOK] |= bb_of(rook_to);
 			color[c] &= ~bb_of(rook_from);
 			color[c] |= bb_of(rook_to);
+			set_square(rook_from, PIECE_NONE, COLOR_NONE);
+			set_square(rook_to, ROOK, c);
 		}
 		castling = Castling(
 		    castling & ~(c == WHITE ? WHITE_CASTLE : BLACK_CASTLE));
@@ -807,7 +917,27 @@ bool Chessboard::make_move(board::Move move) {
 	color[c] &= ~bb_of(from);
 	pieces[new_piece] |= bb_of(to);
 	color[c] |= bb_of(to);
+	set_square(from, PIECE_NONE, COLOR_NONE);
+	set_square(to, new_piece, c);
 	turn_count++;
+	if (piece == PAWN || captured != PIECE_NONE) {
+		halfmove_clock = 0;
+		history.clear();
+	} else {
+		halfmove_clock++;
+		history.push(old_key);
+	}
+	update_attacks(changed);
+
+	key ^= zobrist::keys.side;
+	key ^= zobrist::keys.castling[old_castling] ^
+	       zobrist::keys.castling[castling];
+	if (old_enpassant != SQ_NONE) {
+		key ^= zobrist::keys.enpassant[col_of(old_enpassant)];
+	}
+	if (enpassant != SQ_NONE) {
+		key ^= zobrist::keys.enpassant[col_of(enpassant)];
+	}
 
 	if (turn_count % 2 == WHITE) {
 		compute_legal<WHITE>();
@@ -815,6 +945,72 @@ bool Chessboard::make_move(board::Move move) {
 		compute_legal<BLACK>();
 	}
 
-	last_move = move;
+	last_move    = move;
+	last_capture = captured == PIECE_NONE
+			   ? board::xx
+			   : board::Colored_piece(convert(captured),
+						  convert(enemy(c)));
 	return true;
 }
+
+bool Chessboard::gives_check(board::Move move) const {
+	const Square from = convert(move.from);
+	const Square to   = convert(move.to);
+	const Color c     = Color(turn_count % 2);
+	const Piece piece = get_piece(from);
+	const Piece moved =
+	    move.promotion != board::NO_PIECE ? convert(move.promotion) : piece;
+	const Bitboard king = pieces[KING] & color[enemy(c)];
+	const Square target = Square(lsb(king));
+
+	// squares emptied by the move, en passant and castling empty a second
+	// one
+	Bitboard vacated = bb_of(from);
+	Bitboard filled  = bb_of(to);
+	const int up     = c == WHITE ? 8 : -8;
+	if (piece == PAWN && enpassant != SQ_NONE && to == enpassant + up) {
+		vacated |= bb_of(enpassant);
+	} else if (piece == KING && abs(to - from) == 2) {
+		vacated |= bb_of(Square(to > from ? from + 3 : from - 4));
+		filled |= bb_of(Square(to > from ? from + 1 : from - 1));
+	}
+	const Bitboard occupied =
+	    ((color[WHITE] | color[BLACK]) & ~vacated) | filled;
+
+	Bitboard direct = BOARD_CLEAR;
+	switch (moved) {
+	case PAWN:
+		direct = PAWN_ATTACKS[c][to];
+		break;
+	case KNIGHT:
+		direct = attacks_of<KNIGHT>(to, occupied);
+		break;
+	case BISHOP:
+		direct = attacks_of<BISHOP>(to, occupied);
+		break;
+	case ROOK:
+		direct = attacks_of<ROOK>(to, occupied);
+		break;
+	case QUEEN:
+		direct = attacks_of<QUEEN>(to, occupied);
+		break;
+	default:
+		break;
+	}
+	if (direct & king) return true;
+
+	// anything else is a discovered check, through a vacated square on a
+	// line of the king, or by the rook of a castling
+	const bool is_castling = filled & ~bb_of(to);
+	if (!is_castling &&
+	    !((ROOK_RAYS[target] | BISHOP_RAYS[target]) & vacated)) {
+		return false;
+	}
+	const Bitboard ours     = (color[c] & ~vacated) | filled;
+	const Bitboard straight = ((pieces[ROOK] | pieces[QUEEN]) | filled) &
+				  ours & ~bb_of(to);
+	const Bitboard diagonal =
+	    (pieces[BISHOP] | pieces[QUEEN]) & ours & ~bb_of(to);
+	return (rook_attacks(target, occupied) & straight) ||
+	       (bishop_attacks(target, occupied) & diagonal);
+}
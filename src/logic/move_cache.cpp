@@ -0,0 +1,19 @@
+#include "logic/move_cache.hpp"
+
+#include <bit>
+
+namespace logic {
+Move_cache::Move_cache(size_t size) {
+	size    = size ? std::bit_floor(size) : 1;
+	mask    = size - 1;
+	entries = std::vector<Move_set>(size);
+	clear();
+}
+
+void Move_cache::clear() {
+	// no position hashes to this key in the slot at index 0
+	for (size_t i = 0; i < entries.size(); i++) entries[i].key = ~i;
+	hits   = 0;
+	probes = 0;
+}
+}  // namespace logic
@@ -0,0 +1,117 @@
+#include "logic/slider_kernel.hpp"
+
+#include "utils/cpu.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SLIDER_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace logic {
+
+constexpr Bitboard ALL_SQUARES = ~BOARD_CLEAR;
+constexpr Bitboard NOT_COL_A   = ~bb_of(COL_A);
+constexpr Bitboard NOT_COL_H   = ~bb_of(COL_H);
+
+template <int s>
+constexpr Bitboard shift_by(Bitboard bitboard) {
+	if constexpr (s > 0) {
+		return bitboard << s;
+	} else {
+		return bitboard >> -s;
+	}
+}
+
+// squares reached from gen through the propagator, shifting by s, the mask
+// drops the squares that wrapped around the board
+template <int s>
+inline Bitboard occluded_fill(Bitboard gen, Bitboard pro, Bitboard mask) {
+	pro &= mask;
+	gen |= pro & shift_by<s>(gen);
+	pro &= shift_by<s>(pro);
+	gen |= pro & shift_by<2 * s>(gen);
+	pro &= shift_by<2 * s>(pro);
+	gen |= pro & shift_by<4 * s>(gen);
+	return shift_by<s>(gen) & mask;
+}
+
+Bitboard slider_attacks_scalar(Bitboard straight, Bitboard diagonal,
+			       Bitboard empty) {
+	return occluded_fill<8>(straight, empty, ALL_SQUARES) |
+	       occluded_fill<-8>(straight, empty, ALL_SQUARES) |
+	       occluded_fill<1>(straight, empty, NOT_COL_A) |
+	       occluded_fill<-1>(straight, empty, NOT_COL_H) |
+	       occluded_fill<9>(diagonal, empty, NOT_COL_A) |
+	       occluded_fill<7>(diagonal, empty, NOT_COL_H) |
+	       occluded_fill<-7>(diagonal, empty, NOT_COL_A) |
+	       occluded_fill<-9>(diagonal, empty, NOT_COL_H);
+}
+
+#ifdef SLIDER_KERNEL_X86
+// occluded fill of the four lanes, going up the board
+__attribute__((target("avx2"))) static inline __m256i fill_up(
+    __m256i gen, __m256i pro, __m256i shift) {
+	const __m256i shift2 = _mm256_add_epi64(shift, shift);
+	const __m256i shift4 = _mm256_add_epi64(shift2, shift2);
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift)));
+	pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift));
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift2)));
+	pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, shift2));
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, shift4)));
+	return _mm256_sllv_epi64(gen, shift);
+}
+
+// same going down the board
+__attribute__((target("avx2"))) static inline __m256i fill_down(
+    __m256i gen, __m256i pro, __m256i shift) {
+	const __m256i shift2 = _mm256_add_epi64(shift, shift);
+	const __m256i shift4 = _mm256_add_epi64(shift2, shift2);
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift)));
+	pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift));
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift2)));
+	pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, shift2));
+	gen = _mm256_or_si256(
+	    gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, shift4)));
+	return _mm256_srlv_epi64(gen, shift);
+}
+
+// lanes: north, east, north east and north west going up, south, west, south
+// west and south east going down, so both use the same shifts
+__attribute__((target("avx2"))) Bitboard slider_attacks_avx2(
+    Bitboard straight, Bitboard diagonal, Bitboard empty) {
+	const __m256i shift = _mm256_setr_epi64x(8, 1, 9, 7);
+	const __m256i up_mask =
+	    _mm256_setr_epi64x(ALL_SQUARES, NOT_COL_A, NOT_COL_A, NOT_COL_H);
+	const __m256i down_mask =
+	    _mm256_setr_epi64x(ALL_SQUARES, NOT_COL_H, NOT_COL_H, NOT_COL_A);
+	const __m256i sliders =
+	    _mm256_setr_epi64x(straight, straight, diagonal, diagonal);
+	const __m256i free = _mm256_set1_epi64x(empty);
+
+	const __m256i up = _mm256_and_si256(
+	    fill_up(sliders, _mm256_and_si256(free, up_mask), shift), up_mask);
+	const __m256i down = _mm256_and_si256(
+	    fill_down(sliders, _mm256_and_si256(free, down_mask), shift),
+	    down_mask);
+
+	const __m256i lanes = _mm256_or_si256(up, down);
+	const __m128i half  = _mm_or_si128(_mm256_castsi256_si128(lanes),
+					   _mm256_extracti128_si256(lanes, 1));
+	return Bitboard(_mm_cvtsi128_si64(half) | _mm_extract_epi64(half, 1));
+}
+
+bool has_avx2() { return cpu_features().avx2; }
+#else
+Bitboard slider_attacks_avx2(Bitboard straight, Bitboard diagonal,
+			     Bitboard empty) {
+	return slider_attacks_scalar(straight, diagonal, empty);
+}
+
+bool has_avx2() { return false; }
+#endif
+}  // namespace logic
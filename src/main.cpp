@@ -1,68 +1,305 @@
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 
 #include "controller/controller.hpp"
+#include "notation/pgn_writer.hpp"
 #include "player/player_bot.hpp"
 #include "player/player_random.hpp"
+#include "player/player_shm.hpp"
 #include "player/player_tui.hpp"
+#include "tools/bench.hpp"
+#include "tools/engine.hpp"
+#include "tools/host.hpp"
+#include "tools/match.hpp"
+#include "tools/pgn_check.hpp"
+#include "tools/remote.hpp"
+#include "tools/replay.hpp"
+#include "utils/thread_pool.hpp"
+#include "view/view_async.hpp"
 #include "view/view_tui.hpp"
 
-std::unique_ptr<Player> get_player(std::string player) {
+std::unique_ptr<Player> get_player(std::string player,
+				   std::ostream &out = std::cout) {
 	if (player == "human") {
 		return std::make_unique<Player_tui>();
 	} else if (player == "bot") {
-		return std::make_unique<Player_bot>();
+		return std::make_unique<Player_bot>(Bot_params{}, out);
 	} else if (player == "random") {
 		return std::make_unique<Player_random>();
+	} else if (player.rfind("shm:", 0) == 0) {
+		return std::make_unique<Player_shm>(player.substr(4));
 	}
 	throw std::runtime_error("Invalid player type");
 }
 
 void print_usage(char *argv[]) {
 	std::cout << "Usage: " << argv[0]
-		  << " < -w [player type] > < -b [player_type] >" << std::endl;
-	std::cout << "Player types: human, bot, random" << std::endl;
+		  << " < -w [player type] > < -b [player_type] >"
+		  << " < -o [file.pgn] > < -r [scroll|diff] >" << std::endl;
+	std::cout << "Player types: human, bot, random, shm:/name" << std::endl;
+	std::cout << "       " << argv[0] << " pgn [-j threads] files..."
+		  << std::endl;
+	std::cout << "       " << argv[0]
+		  << " replay [-j threads] [transcripts or directories...]"
+		  << std::endl;
+	std::cout << "       " << argv[0] << " bench [depth]" << std::endl;
+	std::cout << "       " << argv[0]
+		  << " match [-j threads] [-n games]"
+		  << " [-a depth[:mobility[:cache]]]"
+		  << " [-b depth[:mobility[:cache]]] [-e elo0 elo1] [openings]"
+		  << std::endl;
+	std::cout << "       " << argv[0]
+		  << " host [-j threads] [-n games] [-w player_type]"
+		  << " [-b player_type]" << std::endl;
+	std::cout << "Hosted player types: random, bot,"
+		  << " bot:depth[:mobility[:cache]]"
+		  << std::endl;
+	std::cout << "       " << argv[0]
+		  << " serve [-j threads] [-p port] [-t timeout_ms]"
+		  << std::endl;
+	std::cout << "       " << argv[0]
+		  << " loopback [-j threads] [-n clients] [-t timeout_ms]"
+		  << std::endl;
+	std::cout << "       " << argv[0] << " engine /name [player_type]"
+		  << std::endl;
+	std::cout << "       " << argv[0] << " transport [round_trips]"
+		  << std::endl;
+}
+
+// parse the arguments of the tools: [-j threads] paths...
+size_t parse_tool_args(int argc, char *argv[],
+		       std::vector<std::string> &paths) {
+	size_t threads = Thread_pool::default_size();
+	for (int i = 2; i < argc; i++) {
+		if (std::string(argv[i]) == "-j" && i + 1 < argc) {
+			threads = std::stoul(argv[++i]);
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	return threads;
+}
+
+// parse the arguments of the match mode, the engines default to depth 2
+bool parse_match_args(int argc, char *argv[], Match_options &options) {
+	options.threads    = Thread_pool::default_size();
+	options.engines[0] = parse_bot_params("2");
+	options.engines[1] = parse_bot_params("2");
+	for (int i = 2; i < argc; i++) {
+		const std::string option = argv[i];
+		const bool has_value     = i + 1 < argc;
+		if (option == "-j" && has_value) {
+			options.threads = std::stoul(argv[++i]);
+		} else if (option == "-n" && has_value) {
+			options.games = std::stoul(argv[++i]);
+		} else if (option == "-a" && has_value) {
+			options.engines[0] = parse_bot_params(argv[++i]);
+		} else if (option == "-b" && has_value) {
+			options.engines[1] = parse_bot_params(argv[++i]);
+		} else if (option == "-e" && i + 2 < argc) {
+			options.elo0 = std::stod(argv[++i]);
+			options.elo1 = std::stod(argv[++i]);
+		} else if (option[0] != '-' && options.openings.empty()) {
+			options.openings = option;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+// parse the arguments of the host mode and run it
+int run_host(int argc, char *argv[]) {
+	size_t threads = Thread_pool::default_size();
+	size_t games   = 100;
+	std::string white_type = "random";
+	std::string black_type = "random";
+	for (int i = 2; i < argc; i += 2) {
+		const std::string option = argv[i];
+		if (i + 1 >= argc) return -1;
+		if (option == "-j") {
+			threads = std::stoul(argv[i + 1]);
+		} else if (option == "-n") {
+			games = std::stoul(argv[i + 1]);
+		} else if (option == "-w") {
+			white_type = argv[i + 1];
+		} else if (option == "-b") {
+			black_type = argv[i + 1];
+		} else {
+			return -1;
+		}
+	}
+	return host(games, threads, white_type, black_type);
+}
+
+// parse the arguments of the serve and loopback modes and run them
+int run_remote(int argc, char *argv[]) {
+	const bool is_loopback = std::string(argv[1]) == "loopback";
+	size_t threads         = Thread_pool::default_size();
+	size_t clients         = 64;
+	unsigned long port     = 4242;
+	std::chrono::milliseconds timeout(is_loopback ? 1000 : 30000);
+	for (int i = 2; i < argc; i += 2) {
+		const std::string option = argv[i];
+		if (i + 1 >= argc) return -1;
+		if (option == "-j") {
+			threads = std::stoul(argv[i + 1]);
+		} else if (option == "-n" && is_loopback) {
+			clients = std::stoul(argv[i + 1]);
+		} else if (option == "-p" && !is_loopback) {
+			port = std::stoul(argv[i + 1]);
+			if (port > UINT16_MAX) return -1;
+		} else if (option == "-t") {
+			timeout =
+			    std::chrono::milliseconds(std::stoul(argv[i + 1]));
+		} else {
+			return -1;
+		}
+	}
+	if (is_loopback) return loopback(clients, threads, timeout);
+	return serve(port, threads, timeout);
 }
 
 int main(int argc, char *argv[]) {
-	if (argc > 5) {
+	const std::string mode = argc > 1 ? argv[1] : "";
+	if (mode == "bench") {
+		int depth = 5;
+		try {
+			if (argc > 2) depth = std::stoi(argv[2]);
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+			depth = 0;
+		}
+		if (argc > 3 || depth < 1) {
+			print_usage(argv);
+			return 1;
+		}
+		return bench(depth);
+	}
+	if (mode == "transport") {
+		size_t round_trips = 10000;
+		try {
+			if (argc > 2) round_trips = std::stoul(argv[2]);
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+			round_trips = 0;
+		}
+		if (argc > 3 || round_trips == 0) {
+			print_usage(argv);
+			return 1;
+		}
+		return transport_bench(round_trips);
+	}
+	if (mode == "engine") {
+		try {
+			const std::string type = argc == 4 ? argv[3] : "bot";
+			if (argc == 3 || argc == 4) {
+				return engine(argv[2], type);
+			}
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+		}
 		print_usage(argv);
 		return 1;
 	}
-	std::unique_ptr<Player> white;
-	std::unique_ptr<Player> black;
-
-	if (argc == 1) {
-		white = std::make_unique<Player_tui>();
-		black = std::make_unique<Player_tui>();
-	} else if (argc == 3) {
-		if (std::string(argv[1]) == "-w") {
-			white = get_player(argv[2]);
-			black = std::make_unique<Player_tui>();
-		} else if (std::string(argv[1]) == "-b") {
-			white = std::make_unique<Player_tui>();
-			black = get_player(argv[2]);
-		} else {
+	if (mode == "match") {
+		Match_options options;
+		bool is_valid;
+		try {
+			is_valid = parse_match_args(argc, argv, options);
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+			is_valid = false;
+		}
+		if (!is_valid) {
 			print_usage(argv);
 			return 1;
 		}
-	} else if (argc == 5) {
-		if (std::string(argv[1]) == "-w" &&
-		    std::string(argv[3]) == "-b") {
-			white = get_player(argv[2]);
-			black = get_player(argv[4]);
-		} else if (std::string(argv[1]) == "-b" &&
-			   std::string(argv[3]) == "-w") {
-			white = get_player(argv[4]);
-			black = get_player(argv[2]);
+		return match(options);
+	}
+	if (mode == "host" || mode == "serve" || mode == "loopback") {
+		int status;
+		try {
+			status = mode == "host" ? run_host(argc, argv)
+						: run_remote(argc, argv);
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+			status = -1;
+		}
+		if (status < 0) {
+			print_usage(argv);
+			return 1;
+		}
+		return status;
+	}
+	if (mode == "pgn" || mode == "replay") {
+		std::vector<std::string> paths;
+		size_t threads;
+		try {
+			threads = parse_tool_args(argc, argv, paths);
+		} catch (const std::invalid_argument &e) {
+			std::cerr << e.what() << std::endl;
+			print_usage(argv);
+			return 1;
+		}
+		if (mode == "replay") {
+			if (paths.empty()) paths.push_back("data");
+			return replay(paths, threads);
+		}
+		if (paths.empty()) {
+			print_usage(argv);
+			return 1;
+		}
+		return pgn_check(paths, threads);
+	}
+	std::string white_type = "human";
+	std::string black_type = "human";
+	std::string pgn_path;
+	View_tui::Mode render = View_tui::SCROLL;
+	for (int i = 1; i < argc; i += 2) {
+		const std::string option = argv[i];
+		if (i + 1 >= argc) {
+			print_usage(argv);
+			return 1;
+		}
+		if (option == "-w") {
+			white_type = argv[i + 1];
+		} else if (option == "-b") {
+			black_type = argv[i + 1];
+		} else if (option == "-o") {
+			pgn_path = argv[i + 1];
+		} else if (option == "-r" &&
+			   std::string(argv[i + 1]) == "scroll") {
+			render = View_tui::SCROLL;
+		} else if (option == "-r" &&
+			   std::string(argv[i + 1]) == "diff") {
+			render = View_tui::DIFF;
 		} else {
 			print_usage(argv);
 			return 1;
 		}
 	}
 
-	Controller controller(std::move(white), std::move(black),
-			      std::make_unique<View_tui>());
+	std::unique_ptr<notation::Pgn_writer> recorder;
+	if (!pgn_path.empty()) {
+		recorder = std::make_unique<notation::Pgn_writer>(pgn_path);
+		recorder->set_players(white_type, black_type);
+	}
+
+	std::unique_ptr<View> view = std::make_unique<View_tui>(render);
+	std::ostream *log          = &std::cout;
+	// without anyone to prompt, the board is drawn on another thread, the
+	// moves of the bots go through it to stay in order with the boards
+	if (white_type != "human" && black_type != "human") {
+		auto async = std::make_unique<View_async>(std::move(view));
+		log        = &async->get_log();
+		view       = std::move(async);
+	}
+	Controller controller(get_player(white_type, *log),
+			      get_player(black_type, *log), std::move(view));
+	controller.set_recorder(recorder.get());
 	controller.start();
 	return 0;
 }
@@ -0,0 +1,69 @@
+#include "net/protocol.hpp"
+
+namespace net {
+static void put(std::vector<uint8_t> &output, uint64_t value, size_t bytes) {
+	for (size_t i = 0; i < bytes; i++) output.push_back(value >> (8 * i));
+}
+
+static uint64_t get(const uint8_t *&data, size_t bytes) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < bytes; i++) {
+		value |= uint64_t(*data++) << (8 * i);
+	}
+	return value;
+}
+
+static uint16_t pack(const board::Move &move) {
+	const unsigned from = move.from.col + move.from.line * 8;
+	const unsigned to   = move.to.col + move.to.line * 8;
+	return (from & 63) | (to & 63) << 6 | (move.promotion & 15) << 12;
+}
+
+static board::Move unpack(uint16_t value) {
+	const unsigned from = value & 63;
+	const unsigned to   = value >> 6 & 63;
+	return board::Move{
+	    board::Square(board::Line(from / 8), board::Column(from % 8)),
+	    board::Square(board::Line(to / 8), board::Column(to % 8)),
+	    board::Piece(value >> 12)};
+}
+
+void encode(const Frame &frame, std::vector<uint8_t> &output) {
+	put(output, FRAME_SIZE - 2, 2);
+	put(output, PROTOCOL_VERSION, 1);
+	put(output, frame.type, 1);
+	put(output, frame.game, 4);
+	put(output, frame.sequence, 2);
+	put(output, frame.action, 1);
+	put(output, pack(frame.move), 2);
+	put(output, frame.time_left_ms, 4);
+	put(output, frame.time_used_ms, 4);
+}
+
+Decode_status decode(const uint8_t *data, size_t size, Frame &frame,
+		     size_t &consumed) {
+	if (size < 2) return NEED_MORE;
+	const size_t length = 2 + get(data, 2);
+	if (length < FRAME_SIZE || length > MAX_FRAME_SIZE) return MALFORMED;
+	if (size < length) return NEED_MORE;
+	// a later version keeps the fields of this one and appends its own
+	// after them, skipped with the rest of the length
+	if (get(data, 1) < PROTOCOL_VERSION) return MALFORMED;
+	const uint64_t type = get(data, 1);
+	if (type > RESYNC) return MALFORMED;
+
+	frame.type         = Frame_type(type);
+	frame.game         = get(data, 4);
+	frame.sequence     = get(data, 2);
+	frame.action       = get(data, 1);
+	frame.move         = unpack(get(data, 2));
+	frame.time_left_ms = get(data, 4);
+	frame.time_used_ms = get(data, 4);
+	consumed           = length;
+	return DECODED;
+}
+
+bool is_valid_answer(const Frame &frame) {
+	return frame.action <= DRAW && frame.move.promotion <= board::KING;
+}
+}  // namespace net
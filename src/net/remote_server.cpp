@@ -0,0 +1,510 @@
+#include "net/remote_server.hpp"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+namespace net {
+// epoll identifiers of the two file descriptors that aren't connections
+constexpr uint64_t LISTENER = 0;
+constexpr uint64_t WAKEUP   = UINT64_MAX;
+// how often the deadlines are checked
+constexpr auto TICK = std::chrono::milliseconds(20);
+
+static std::runtime_error system_error(const std::string &what) {
+	return std::runtime_error(what + ": " + strerror(errno));
+}
+
+// --- Remote_player ---
+
+// seat mutex held, add the moves played since the last request: the answer
+// of the player, then the move of its opponent
+void Remote_player::update_history(const Chessboard &chessboard) {
+	const size_t plies = chessboard.get_turn_count();
+	if (!seat->has_history) {
+		seat->has_history = true;
+		seat->first_ply   = plies > 0 ? plies - 1 : 0;
+	}
+	std::vector<board::Move> &history = seat->history;
+	if (seat->first_ply + history.size() + 2 == plies) {
+		history.push_back(seat->proposed);
+	}
+	if (seat->first_ply + history.size() + 1 == plies) {
+		history.push_back(chessboard.get_last_move());
+	}
+}
+
+Move_future Remote_player::request(const Chessboard &chessboard,
+				   Frame_type type) {
+	using std::chrono::duration_cast;
+	using std::chrono::milliseconds;
+	Move_promise promise;
+	Move_future future = promise.get_future();
+	std::unique_lock<std::mutex> lock(seat->mutex);
+	if (!seat->is_connected) {
+		lock.unlock();
+		promise.set_value({RESIGN, {}});
+		return future;
+	}
+	update_history(chessboard);
+	seat->promise  = std::move(promise);
+	seat->sequence = chessboard.get_turn_count();
+	seat->asked    = Clock::now();
+	seat->deadline = seat->asked + seat->timeout;
+
+	Frame frame;
+	frame.type         = type;
+	frame.game         = seat->game;
+	frame.sequence     = seat->sequence;
+	frame.move         = chessboard.get_last_move();
+	frame.time_left_ms = seat->timeout.count();
+	frame.time_used_ms = duration_cast<milliseconds>(seat->used).count();
+	lock.unlock();
+	send(frame);
+	return future;
+}
+
+void Remote_player::send(const Frame &frame, bool is_last) {
+	server.send(seat->connection, frame, is_last);
+}
+
+void Remote_player::set_game(uint32_t game) {
+	std::lock_guard<std::mutex> lock(seat->mutex);
+	seat->game = game;
+}
+
+void Remote_player::start_new_game(bool is_white) {
+	Frame frame;
+	frame.type = START;
+	{
+		std::lock_guard<std::mutex> lock(seat->mutex);
+		frame.game         = seat->game;
+		frame.time_left_ms = seat->timeout.count();
+	}
+	frame.action = is_white ? logic::WHITE : logic::BLACK;
+	send(frame);
+}
+
+Move_future Remote_player::play(const Chessboard &chessboard) {
+	return request(chessboard, YOUR_TURN);
+}
+
+Move_future Remote_player::invalid_move(const Chessboard &chessboard) {
+	return request(chessboard, INVALID);
+}
+
+void Remote_player::end(const Chessboard &chessboard) {
+	Frame frame;
+	frame.type = GAME_OVER;
+	{
+		std::lock_guard<std::mutex> lock(seat->mutex);
+		update_history(chessboard);
+		frame.game = seat->game;
+	}
+	// the last move is sent, even to the player that didn't see it
+	frame.sequence = chessboard.get_turn_count();
+	frame.action   = chessboard.get_game_state();
+	frame.move     = chessboard.get_last_move();
+	send(frame, true);
+}
+
+// --- Remote_server ---
+
+Remote_server::Remote_server(
+    uint16_t port, std::chrono::milliseconds timeout,
+    std::function<void(std::unique_ptr<Remote_player>)> on_player,
+    const std::string &address)
+    : timeout(timeout), on_player(std::move(on_player)) {
+	sockaddr_in socket_address{};
+	socket_address.sin_family = AF_INET;
+	socket_address.sin_port   = htons(port);
+	if (inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) !=
+	    1) {
+		throw std::runtime_error("Invalid address " + address);
+	}
+
+	listener =
+	    socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	epoll  = epoll_create1(EPOLL_CLOEXEC);
+	wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	const int reuse = 1;
+	socklen_t length = sizeof(socket_address);
+	epoll_event listen_event{EPOLLIN, {.u64 = LISTENER}};
+	epoll_event wakeup_event{EPOLLIN, {.u64 = WAKEUP}};
+	if (listener < 0 || epoll < 0 || wakeup < 0 ||
+	    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse,
+		       sizeof(reuse)) < 0 ||
+	    bind(listener, (sockaddr *)&socket_address,
+		 sizeof(socket_address)) < 0 ||
+	    listen(listener, SOMAXCONN) < 0 ||
+	    getsockname(listener, (sockaddr *)&socket_address, &length) < 0 ||
+	    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &listen_event) < 0 ||
+	    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &wakeup_event) < 0) {
+		const std::runtime_error error =
+		    system_error("Can't listen on port " +
+				 std::to_string(port));
+		::close(listener);
+		::close(epoll);
+		::close(wakeup);
+		throw error;
+	}
+	this->port = ntohs(socket_address.sin_port);
+	thread     = std::thread([this] { run(); });
+}
+
+Remote_server::~Remote_server() {
+	is_stopped = true;
+	const uint64_t one = 1;
+	(void)!write(wakeup, &one, sizeof(one));
+	thread.join();
+	::close(listener);
+	::close(epoll);
+	::close(wakeup);
+}
+
+Server_stats Remote_server::get_stats() {
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	return stats;
+}
+
+void Remote_server::count(uint64_t Server_stats::*counter, uint64_t value) {
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	stats.*counter += value;
+}
+
+void Remote_server::send(uint64_t connection, const Frame &frame,
+			 bool is_last) {
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		commands.push_back({connection, frame, is_last});
+	}
+	const uint64_t one = 1;
+	(void)!write(wakeup, &one, sizeof(one));
+}
+
+void Remote_server::run() {
+	epoll_event events[256];
+	Clock::time_point last_check = Clock::now();
+	while (!is_stopped) {
+		const int count = epoll_wait(epoll, events, 256, TICK.count());
+		if (count < 0 && errno != EINTR) {
+			std::cerr << "epoll_wait: " << strerror(errno)
+				  << std::endl;
+			break;
+		}
+		for (int i = 0; i < count; i++) {
+			const uint64_t id = events[i].data.u64;
+			if (id == LISTENER) {
+				accept_all();
+				continue;
+			}
+			if (id == WAKEUP) {
+				uint64_t value;
+				(void)!read(wakeup, &value, sizeof(value));
+				continue;
+			}
+			auto found = connections.find(id);
+			if (found == connections.end()) continue;
+			Connection &connection = found->second;
+			if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+				disconnect(id);
+				continue;
+			}
+			if (events[i].events & (EPOLLIN | EPOLLRDHUP) &&
+			    !read_all(id, connection)) {
+				continue;
+			}
+			if (events[i].events & EPOLLOUT) flush(id, connection);
+		}
+		carry_out_commands();
+		flush_all();
+		if (Clock::now() - last_check >= TICK) {
+			check_timeouts();
+			last_check = Clock::now();
+		}
+	}
+
+	// the games still waiting for an answer get a resignation
+	while (!connections.empty()) disconnect(connections.begin()->first);
+}
+
+void Remote_server::accept_all() {
+	while (true) {
+		const int fd = accept4(listener, nullptr, nullptr,
+				       SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				std::cerr << "accept: " << strerror(errno)
+					  << std::endl;
+			}
+			return;
+		}
+		const int no_delay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+			   sizeof(no_delay));
+
+		const uint64_t id = next_id++;
+		auto seat         = std::make_shared<Seat>();
+		seat->connection  = id;
+		seat->timeout     = timeout;
+		epoll_event event{EPOLLIN | EPOLLRDHUP, {.u64 = id}};
+		if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) < 0) {
+			::close(fd);
+			continue;
+		}
+		Connection connection;
+		connection.fd   = fd;
+		connection.seat = seat;
+		connection.input.reserve(FRAME_SIZE);
+		connections.emplace(id, std::move(connection));
+		{
+			std::lock_guard<std::mutex> lock(stats_mutex);
+			stats.accepted++;
+			stats.connections++;
+		}
+		on_player(std::make_unique<Remote_player>(*this, seat));
+	}
+}
+
+// false if the connection was closed
+bool Remote_server::read_all(uint64_t id, Connection &connection) {
+	uint8_t buffer[4096];
+	uint64_t reads = 0, bytes = 0, frames = 0;
+	// every way out goes through the stats at the bottom
+	bool is_open = true;
+	while (is_open) {
+		const ssize_t received =
+		    recv(connection.fd, buffer, sizeof(buffer), 0);
+		reads++;
+		if (received < 0 && errno == EINTR) continue;
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+		if (received <= 0) {
+			disconnect(id);
+			is_open = false;
+			break;
+		}
+		bytes += received;
+
+		// frames can be split or grouped in any way by TCP
+		std::vector<uint8_t> &input = connection.input;
+		input.insert(input.end(), buffer, buffer + received);
+		size_t offset = 0;
+		Frame frame;
+		size_t consumed;
+		Decode_status status;
+		while (is_open &&
+		       (status = decode(input.data() + offset,
+					input.size() - offset, frame,
+					consumed)) == DECODED) {
+			offset += consumed;
+			frames++;
+			is_open = receive(id, connection, frame);
+		}
+		if (!is_open) break;
+		if (status == MALFORMED) {
+			count(&Server_stats::protocol_errors);
+			disconnect(id);
+			is_open = false;
+			break;
+		}
+		input.erase(input.begin(), input.begin() + offset);
+		// a short read emptied the socket, no need to ask again
+		if (received < ssize_t(sizeof(buffer))) break;
+	}
+
+	std::lock_guard<std::mutex> lock(stats_mutex);
+	stats.reads += reads;
+	stats.bytes_received += bytes;
+	stats.frames_received += frames;
+	return is_open;
+}
+
+// false if the connection was closed
+bool Remote_server::receive(uint64_t id, Connection &connection,
+			    const Frame &frame) {
+	Seat &seat = *connection.seat;
+	std::optional<Move_promise> promise;
+	{
+		std::lock_guard<std::mutex> lock(seat.mutex);
+		if (frame.type == RESYNC && frame.game == seat.game) {
+			resync(connection, frame);
+			return true;
+		}
+		const bool is_expected = frame.type == MOVE && seat.promise &&
+					 frame.game == seat.game &&
+					 frame.sequence == seat.sequence &&
+					 is_valid_answer(frame);
+		if (is_expected) {
+			promise.swap(seat.promise);
+			seat.used += Clock::now() - seat.asked;
+			if (frame.action == PLAY) seat.proposed = frame.move;
+		}
+	}
+	if (!promise) {
+		count(&Server_stats::protocol_errors);
+		disconnect(id);
+		return false;
+	}
+	promise->set_value({Action(frame.action), frame.move});
+	return true;
+}
+
+// seat mutex held, queue the moves of the game from the ply asked
+void Remote_server::resync(Connection &connection, const Frame &frame) {
+	const Seat &seat = *connection.seat;
+	Frame move;
+	move.type     = HISTORY;
+	move.game     = seat.game;
+	uint64_t sent = 0;
+	for (size_t i = 0; i < seat.history.size(); i++) {
+		move.sequence = seat.first_ply + i;
+		if (move.sequence < frame.sequence) continue;
+		move.move = seat.history[i];
+		queue(seat.connection, connection, move);
+		sent++;
+	}
+	count(&Server_stats::resyncs);
+	count(&Server_stats::frames_sent, sent);
+}
+
+void Remote_server::queue(uint64_t id, Connection &connection,
+			  const Frame &frame) {
+	encode(frame, connection.output);
+	if (!connection.is_dirty) {
+		connection.is_dirty = true;
+		dirty.push_back(id);
+	}
+}
+
+// false if the connection was closed
+bool Remote_server::flush(uint64_t id, Connection &connection) {
+	std::vector<uint8_t> &output = connection.output;
+	uint64_t writes = 0, bytes = 0;
+	while (connection.output_sent < output.size()) {
+		const size_t offset = connection.output_sent;
+		const ssize_t sent  = ::send(connection.fd, &output[offset],
+					     output.size() - offset,
+					     MSG_NOSIGNAL);
+		writes++;
+		if (sent >= 0) {
+			connection.output_sent += sent;
+			bytes += sent;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			break;
+		} else if (errno != EINTR) {
+			disconnect(id);
+			return false;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		stats.writes += writes;
+		stats.bytes_sent += bytes;
+	}
+
+	const bool is_flushed = connection.output_sent == output.size();
+	if (is_flushed) {
+		output.clear();
+		connection.output_sent = 0;
+		if (connection.close_on_flush) {
+			disconnect(id);
+			return false;
+		}
+	}
+	// wait for the socket to be writable only while bytes are left
+	if (is_flushed == connection.is_writing) {
+		connection.is_writing = !is_flushed;
+		epoll_event event{EPOLLIN | EPOLLRDHUP |
+				      (is_flushed ? 0u : uint32_t(EPOLLOUT)),
+				  {.u64 = id}};
+		epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+	}
+	return true;
+}
+
+// one write per connection for all the frames of the turn
+void Remote_server::flush_all() {
+	for (const uint64_t id : dirty) {
+		auto found = connections.find(id);
+		if (found == connections.end()) continue;
+		found->second.is_dirty = false;
+		// a connection waiting for EPOLLOUT can't take more yet
+		if (!found->second.is_writing) flush(id, found->second);
+	}
+	dirty.clear();
+}
+
+void Remote_server::carry_out_commands() {
+	std::vector<Command> batch;
+	{
+		std::lock_guard<std::mutex> lock(command_mutex);
+		batch.swap(commands);
+	}
+	for (const auto &command : batch) {
+		auto found = connections.find(command.connection);
+		if (found == connections.end()) continue;
+		queue(found->first, found->second, command.frame);
+		found->second.close_on_flush |= command.is_last;
+	}
+	count(&Server_stats::frames_sent, batch.size());
+}
+
+void Remote_server::check_timeouts() {
+	const Clock::time_point now = Clock::now();
+	std::vector<uint64_t> expired;
+	for (auto &[id, connection] : connections) {
+		const Seat &seat = *connection.seat;
+		std::lock_guard<std::mutex> lock(connection.seat->mutex);
+		if (seat.promise && seat.deadline < now) expired.push_back(id);
+	}
+	count(&Server_stats::timeouts, expired.size());
+	for (const uint64_t id : expired) disconnect(id);
+}
+
+void Remote_server::disconnect(uint64_t id) {
+	auto found = connections.find(id);
+	if (found == connections.end()) return;
+	Connection &connection = found->second;
+
+	std::optional<Move_promise> promise;
+	{
+		std::lock_guard<std::mutex> lock(connection.seat->mutex);
+		connection.seat->is_connected = false;
+		promise.swap(connection.seat->promise);
+	}
+	if (promise) promise->set_value({RESIGN, {}});
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		stats.connections--;
+		// the server closes the connection itself after END
+		if (!connection.close_on_flush) stats.disconnected++;
+	}
+
+	epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+	::close(connection.fd);
+	connections.erase(found);
+}
+
+size_t raise_file_limit() {
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) < 0) return 0;
+	limit.rlim_cur = limit.rlim_max;
+	setrlimit(RLIMIT_NOFILE, &limit);
+	getrlimit(RLIMIT_NOFILE, &limit);
+	return limit.rlim_cur;
+}
+}  // namespace net
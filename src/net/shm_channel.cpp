@@ -0,0 +1,197 @@
+#include "net/shm_channel.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace net {
+using Clock = std::chrono::steady_clock;
+
+// bytes of a ring, a power of two
+constexpr uint32_t RING_SIZE = 4096;
+
+struct Shm_channel::Ring {
+	// written by the producer only
+	alignas(64) std::atomic<uint32_t> head;
+	// written by the consumer only
+	alignas(64) std::atomic<uint32_t> tail;
+	// futex word, changed by each write
+	alignas(64) std::atomic<uint32_t> signal;
+	std::atomic<uint32_t> is_waiting;
+	// futex word, changed by each read, for a writer waiting for room
+	alignas(64) std::atomic<uint32_t> room;
+	std::atomic<uint32_t> is_writer_waiting;
+	uint8_t data[RING_SIZE];
+};
+
+struct Shm_channel::Shared {
+	std::atomic<uint32_t> is_closed;
+	// the first one goes from the creator to the other side
+	Ring rings[2];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+		  sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+	      "The futex words are atomics shared by two processes");
+
+static void futex_wait(std::atomic<uint32_t> &word, uint32_t value,
+		       Clock::duration timeout) {
+	using namespace std::chrono;
+	const auto seconds_left = duration_cast<seconds>(timeout);
+	const timespec time     = {
+		seconds_left.count(),
+		duration_cast<nanoseconds>(timeout - seconds_left).count()};
+	// not FUTEX_PRIVATE_FLAG, the word is shared with another process
+	syscall(SYS_futex, &word, FUTEX_WAIT, value, &time, nullptr, 0);
+}
+
+static void futex_wake(std::atomic<uint32_t> &word) {
+	syscall(SYS_futex, &word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static std::runtime_error system_error(const std::string &what) {
+	return std::runtime_error(what + ": " + strerror(errno));
+}
+
+Shm_channel::Shm_channel(const std::string &name, bool create)
+    : name(name), is_owner(create) {
+	const int flags = create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR;
+	const int fd    = shm_open(name.c_str(), flags, 0600);
+	if (fd < 0) throw system_error("Can't open " + name);
+	struct stat status;
+	// the other side may open it before it has its size
+	if ((create && ftruncate(fd, sizeof(Shared)) < 0) ||
+	    fstat(fd, &status) < 0 ||
+	    size_t(status.st_size) < sizeof(Shared)) {
+		const std::runtime_error error =
+		    system_error("Can't size " + name);
+		::close(fd);
+		if (create) shm_unlink(name.c_str());
+		throw error;
+	}
+	void *memory = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE,
+			    MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED) {
+		const std::runtime_error error =
+		    system_error("Can't map " + name);
+		if (create) shm_unlink(name.c_str());
+		throw error;
+	}
+	shared = create ? new (memory) Shared{} : (Shared *)memory;
+	out    = &shared->rings[create ? 0 : 1];
+	in     = &shared->rings[create ? 1 : 0];
+}
+
+Shm_channel::~Shm_channel() {
+	shared->is_closed = 1;
+	for (Ring &ring : shared->rings) {
+		ring.signal++;
+		futex_wake(ring.signal);
+		ring.room++;
+		futex_wake(ring.room);
+	}
+	munmap(shared, sizeof(Shared));
+	if (is_owner) shm_unlink(name.c_str());
+}
+
+bool Shm_channel::send(const Frame &frame) {
+	std::vector<uint8_t> bytes;
+	bytes.reserve(FRAME_SIZE);
+	encode(frame, bytes);
+
+	Ring &ring          = *out;
+	const uint32_t head = ring.head.load(std::memory_order_relaxed);
+
+	auto is_full = [&] {
+		return RING_SIZE - (head - ring.tail) < bytes.size();
+	};
+	while (is_full()) {
+		if (shared->is_closed) return false;
+		// the reader bumps room after moving tail, the same handshake
+		// as the one of wait
+		ring.is_writer_waiting = 1;
+		const uint32_t room    = ring.room;
+		if (is_full() && !shared->is_closed) {
+			futex_wait(ring.room, room, std::chrono::seconds(1));
+		}
+		ring.is_writer_waiting = 0;
+	}
+	for (size_t i = 0; i < bytes.size(); i++) {
+		ring.data[(head + i) % RING_SIZE] = bytes[i];
+	}
+	ring.head.store(head + bytes.size(), std::memory_order_release);
+	// the reader sets is_waiting before it looks at head for the last
+	// time, one of the two sees the other
+	ring.signal++;
+	if (ring.is_waiting) futex_wake(ring.signal);
+	return !shared->is_closed;
+}
+
+// move the bytes of the ring to the input, false if there was none
+bool Shm_channel::read_ring() {
+	Ring &ring          = *in;
+	const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+	const uint32_t head = ring.head.load(std::memory_order_acquire);
+	if (head == tail) return false;
+	for (uint32_t i = tail; i != head; i++) {
+		input.push_back(ring.data[i % RING_SIZE]);
+	}
+	ring.tail.store(head, std::memory_order_release);
+	ring.room++;
+	if (ring.is_writer_waiting) futex_wake(ring.room);
+	return true;
+}
+
+void Shm_channel::wait(Ring &ring, Clock::time_point deadline) {
+	// spinning only helps when the writer runs on another core
+	static const int spins =
+	    std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+	for (int i = 0; i < spins; i++) {
+		if (ring.head.load(std::memory_order_acquire) !=
+		    ring.tail.load(std::memory_order_relaxed)) {
+			return;
+		}
+#if defined(__x86_64__)
+		__builtin_ia32_pause();
+#endif
+	}
+	ring.is_waiting            = 1;
+	const uint32_t signal      = ring.signal;
+	const Clock::duration left = deadline - Clock::now();
+	if (ring.head == ring.tail.load(std::memory_order_relaxed) &&
+	    !shared->is_closed && left > Clock::duration::zero()) {
+		futex_wait(ring.signal, signal, left);
+	}
+	ring.is_waiting = 0;
+}
+
+bool Shm_channel::receive(Frame &frame, Clock::time_point deadline) {
+	while (true) {
+		size_t consumed;
+		const Decode_status status =
+		    decode(input.data(), input.size(), frame, consumed);
+		if (status == DECODED) {
+			input.erase(input.begin(), input.begin() + consumed);
+			return true;
+		}
+		if (status == MALFORMED) return false;
+		// the frames written before the close are read first
+		const bool is_closed = shared->is_closed;
+		if (read_ring()) continue;
+		if (is_closed || Clock::now() >= deadline) return false;
+		wait(*in, deadline);
+	}
+}
+}  // namespace net
@@ -0,0 +1,79 @@
+#include "notation/move_parser.hpp"
+
+namespace notation {
+
+board::Piece parse_promotion(char letter) {
+	switch (letter) {
+	case 'N':
+	case 'n':
+		return board::KNIGHT;
+	case 'B':
+	case 'b':
+		return board::BISHOP;
+	case 'R':
+	case 'r':
+		return board::ROOK;
+	case 'Q':
+	case 'q':
+		return board::QUEEN;
+	default:
+		return board::NO_PIECE;
+	}
+}
+
+static bool is_castle(char c) { return c == 'O' || c == 'o' || c == '0'; }
+
+static bool parse_square(std::string_view input, board::Square &square) {
+	if (input.size() < 2) return false;
+	if (input[0] < 'a' || 'h' < input[0]) return false;
+	if (input[1] < '1' || '8' < input[1]) return false;
+	square = board::Square(board::Line(input[1] - '1'),
+			       board::Column(input[0] - 'a'));
+	return true;
+}
+
+static bool parse_castling(std::string_view input, board::Color color,
+			   board::Move &move) {
+	board::Column to;
+	if (input.size() == 3 && is_castle(input[0]) && input[1] == '-' &&
+	    is_castle(input[2])) {
+		to = board::COL_G;
+	} else if (input.size() == 5 && is_castle(input[0]) &&
+		   input[1] == '-' && is_castle(input[2]) && input[3] == '-' &&
+		   is_castle(input[4])) {
+		to = board::COL_C;
+	} else {
+		return false;
+	}
+	const board::Line line =
+	    color == board::BLACK ? board::LINE_8 : board::LINE_1;
+	move = board::Move{board::Square(line, board::COL_E),
+			   board::Square(line, to)};
+	return true;
+}
+
+bool parse_move(std::string_view input, board::Color color,
+		board::Move &move) {
+	if (!input.empty() && is_castle(input[0])) {
+		return parse_castling(input, color, move);
+	}
+
+	board::Move parsed;
+	if (!parse_square(input, parsed.from)) return false;
+	input.remove_prefix(2);
+	if (!input.empty() && input[0] == '-') input.remove_prefix(1);
+	if (!parse_square(input, parsed.to)) return false;
+	input.remove_prefix(2);
+
+	if (input.size() == 2 && input[0] == '=') input.remove_prefix(1);
+	if (input.size() == 1) {
+		parsed.promotion = parse_promotion(input[0]);
+		if (parsed.promotion == board::NO_PIECE) return false;
+	} else if (!input.empty()) {
+		return false;
+	}
+
+	move = parsed;
+	return true;
+}
+}  // namespace notation
@@ -0,0 +1,253 @@
+#include "notation/pgn_reader.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "notation/san.hpp"
+
+using namespace std;
+
+namespace notation {
+
+Mapped_file::Mapped_file(const string &path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw runtime_error("open " + path + " failed: " +
+				    string(strerror(errno)));
+	}
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		::close(fd);
+		throw runtime_error("stat " + path + " failed: " +
+				    string(strerror(errno)));
+	}
+	size = st.st_size;
+	if (size > 0) {
+		void *address =
+		    mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED) {
+			::close(fd);
+			throw runtime_error("mmap " + path + " failed: " +
+					    string(strerror(errno)));
+		}
+		madvise(address, size, MADV_SEQUENTIAL);
+		data = static_cast<const char *>(address);
+	}
+	::close(fd);
+}
+
+Mapped_file::~Mapped_file() {
+	if (data != nullptr) munmap(const_cast<char *>(data), size);
+}
+
+string_view Pgn_game::get_tag(string_view name) const {
+	for (const auto &tag : tags) {
+		if (tag.name == name) return tag.value;
+	}
+	return {};
+}
+
+static bool is_space(char c) {
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static size_t skip_spaces(string_view text, size_t offset) {
+	while (offset < text.size() && is_space(text[offset])) offset++;
+	return offset;
+}
+
+static size_t end_of_line(string_view text, size_t offset) {
+	const size_t end = text.find('\n', offset);
+	return end == string_view::npos ? text.size() : end;
+}
+
+// [Name "value"]
+static Pgn_tag parse_tag(string_view line) {
+	Pgn_tag tag;
+	size_t name_end = 1;
+	while (name_end < line.size() && !is_space(line[name_end]) &&
+	       line[name_end] != '"' && line[name_end] != ']') {
+		name_end++;
+	}
+	tag.name = line.substr(1, name_end - 1);
+
+	const size_t open  = line.find('"', name_end);
+	const size_t close = line.rfind('"');
+	if (open != string_view::npos && close > open) {
+		tag.value = line.substr(open + 1, close - open - 1);
+	}
+	return tag;
+}
+
+bool Pgn_reader::next_game(Pgn_game &game) {
+	game.tags.clear();
+	game.movetext = {};
+
+	offset = skip_spaces(text, offset);
+	if (offset >= text.size()) return false;
+
+	while (offset < text.size() && text[offset] == '[') {
+		const size_t end       = end_of_line(text, offset);
+		const string_view line = text.substr(offset, end - offset);
+		game.tags.push_back(parse_tag(line));
+		offset = skip_spaces(text, end);
+	}
+
+	// the movetext ends at the next tag section, brackets inside comments
+	// don't count
+	const size_t start = offset;
+	bool in_comment    = false;
+	while (offset < text.size()) {
+		const char c = text[offset];
+		if (in_comment) {
+			in_comment = c != '}';
+		} else if (c == '{') {
+			in_comment = true;
+		} else if (c == ';') {
+			offset = end_of_line(text, offset);
+			continue;
+		} else if (c == '\n' && offset + 1 < text.size() &&
+			   text[offset + 1] == '[') {
+			break;
+		}
+		offset++;
+	}
+	game.movetext = text.substr(start, offset - start);
+	return true;
+}
+
+static bool is_digit(char c) { return '0' <= c && c <= '9'; }
+
+static bool is_delimiter(char c) {
+	return is_space(c) || c == '{' || c == '(' || c == ')' || c == ';';
+}
+
+Pgn_token Movetext_tokenizer::next() {
+	while (offset < text.size()) {
+		const char c = text[offset];
+		if (is_space(c)) {
+			offset++;
+		} else if (c == '{') {
+			const size_t end = text.find('}', offset);
+			offset =
+			    end == string_view::npos ? text.size() : end + 1;
+		} else if (c == ';' || c == '%') {
+			offset = end_of_line(text, offset);
+		} else if (c == '(') {
+			// skip the variation, nested ones included
+			int depth = 0;
+			for (; offset < text.size(); offset++) {
+				const char v = text[offset];
+				if (v == '{') {
+					offset = text.find('}', offset);
+					if (offset == string_view::npos) {
+						offset = text.size();
+						break;
+					}
+				} else if (v == '(') {
+					depth++;
+				} else if (v == ')' && --depth == 0) {
+					offset++;
+					break;
+				}
+			}
+		} else if (c == ')') {
+			offset++;
+		} else if (c == '$') {
+			offset++;
+			while (offset < text.size() && is_digit(text[offset]))
+				offset++;
+		} else {
+			size_t end = offset;
+			while (end < text.size() && !is_delimiter(text[end]))
+				end++;
+			string_view token = text.substr(offset, end - offset);
+			offset            = end;
+
+			if (token == "1-0" || token == "0-1" ||
+			    token == "1/2-1/2" || token == "*") {
+				return {PGN_RESULT, token};
+			}
+			// move number, maybe glued to the move (eg. 12...Nf6)
+			if (is_digit(token[0]) || token[0] == '.') {
+				const size_t dots = token.find_last_of('.');
+				token.remove_prefix(dots + 1);
+			}
+			if (token.empty()) continue;
+			return {PGN_MOVE, token};
+		}
+	}
+	return {PGN_END, {}};
+}
+
+Pgn_replay replay_game(const Pgn_game &game) {
+	Pgn_replay replay;
+	if (!game.get_tag("FEN").empty()) {
+		replay.is_skipped = true;
+		return replay;
+	}
+
+	Movetext_tokenizer tokenizer(game.movetext);
+	Pgn_token token = tokenizer.next();
+	while (token.type == PGN_MOVE) {
+		board::Move move;
+		if (!parse_san(token.text, replay.chessboard, move) ||
+		    !replay.chessboard.make_move(move)) {
+			replay.is_valid = false;
+			replay.bad_move = token.text;
+			return replay;
+		}
+		replay.moves++;
+		token = tokenizer.next();
+	}
+
+	// a finished game can only end with its own result
+	const GameState state = replay.chessboard.get_game_state();
+	if (token.type == PGN_RESULT && state != ONGOING &&
+	    token.text != to_string(state)) {
+		replay.is_valid = false;
+		replay.bad_move = token.text;
+	}
+	return replay;
+}
+
+// a game starts with a tag line preceded by a blank line
+static size_t next_game_start(string_view text, size_t offset) {
+	while (true) {
+		const size_t candidate = text.find("\n[", offset);
+		if (candidate == string_view::npos) return text.size();
+
+		size_t previous = candidate;
+		while (previous > 0 && text[previous - 1] == '\r') previous--;
+		if (previous == 0 || text[previous - 1] == '\n') {
+			return candidate + 1;
+		}
+		offset = candidate + 1;
+	}
+}
+
+vector<string_view> split_games(string_view text, size_t count) {
+	vector<string_view> chunks;
+	if (count == 0) count = 1;
+	const size_t chunk_size = text.size() / count + 1;
+
+	size_t start = 0;
+	while (start < text.size()) {
+		size_t end = start + chunk_size;
+		if (end >= text.size()) {
+			end = text.size();
+		} else {
+			end = next_game_start(text, end);
+		}
+		chunks.push_back(text.substr(start, end - start));
+		start = end;
+	}
+	return chunks;
+}
+}  // namespace notation
@@ -0,0 +1,133 @@
+#include "notation/pgn_writer.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <ctime>
+#include <stdexcept>
+
+#include "notation/san.hpp"
+
+using namespace std;
+
+namespace notation {
+
+// PGN export format keeps lines under 80 chars
+static constexpr size_t MAX_LINE_LENGTH = 79;
+
+static string today() {
+	char date[16];
+	const time_t now = time(nullptr);
+	struct tm local;
+	localtime_r(&now, &local);
+	strftime(date, sizeof(date), "%Y.%m.%d", &local);
+	return date;
+}
+
+Pgn_writer::Pgn_writer(const string &path) : is_owner(true), date(today()) {
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+		    0644);
+	if (fd < 0) {
+		throw runtime_error("open " + path + " failed: " +
+				    string(strerror(errno)));
+	}
+	game.reserve(4096);
+	movetext.reserve(2048);
+}
+
+Pgn_writer::Pgn_writer(int fd) : fd(fd), is_owner(false), date(today()) {
+	game.reserve(4096);
+	movetext.reserve(2048);
+}
+
+Pgn_writer::~Pgn_writer() {
+	if (is_owner) ::close(fd);
+}
+
+void Pgn_writer::set_players(string white, string black) {
+	this->white = std::move(white);
+	this->black = std::move(black);
+}
+
+void Pgn_writer::start_game() {
+	movetext.clear();
+	line_length = 0;
+	ply         = 0;
+}
+
+void Pgn_writer::append_token(string_view token) {
+	if (line_length + 1 + token.size() > MAX_LINE_LENGTH) {
+		movetext += '\n';
+		line_length = 0;
+	} else if (line_length > 0) {
+		movetext += ' ';
+		line_length++;
+	}
+	movetext += token;
+	line_length += token.size();
+}
+
+void Pgn_writer::add_move(string_view san, const Chessboard &chessboard) {
+	if (ply % 2 == 0) {
+		char number[16];
+		char *end = to_chars(number, number + 15, ply / 2 + 1).ptr;
+		*end++    = '.';
+		append_token(string_view(number, end - number));
+	}
+
+	char move[SAN_MAX_LENGTH];
+	size_t length = san.copy(move, SAN_MAX_LENGTH - 1);
+	length += format_check(chessboard, move + length);
+	append_token(string_view(move, length));
+	ply++;
+}
+
+static void append_tag(string &game, string_view name, string_view value) {
+	game += '[';
+	game += name;
+	game += " \"";
+	for (const char c : value) {
+		if (c == '"' || c == '\\') game += '\\';
+		game += c;
+	}
+	game += "\"]\n";
+}
+
+void Pgn_writer::end_game(GameState state) {
+	const string_view result = state == ONGOING ? "*" : to_string(state);
+	append_token(result);
+
+	char number[16];
+	const char *end = to_chars(number, number + 16, ++round).ptr;
+
+	game.clear();
+	append_tag(game, "Event", "chess_project");
+	append_tag(game, "Site", "?");
+	append_tag(game, "Date", date);
+	append_tag(game, "Round", string_view(number, end - number));
+	append_tag(game, "White", white);
+	append_tag(game, "Black", black);
+	append_tag(game, "Result", result);
+	game += '\n';
+	game += movetext;
+	game += "\n\n";
+
+	write_all(game);
+	start_game();
+}
+
+void Pgn_writer::write_all(string_view text) {
+	while (!text.empty()) {
+		const ssize_t written = ::write(fd, text.data(), text.size());
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			throw runtime_error("write failed: " +
+					    string(strerror(errno)));
+		}
+		text.remove_prefix(written);
+	}
+}
+}  // namespace notation
@@ -0,0 +1,250 @@
+#include "notation/san.hpp"
+
+#include "logic/bitboard.hpp"
+#include "logic/chessboard.hpp"
+#include "notation/move_parser.hpp"
+
+using namespace logic;
+
+namespace notation {
+
+static board::Square to_board_square(Square square) {
+	return board::Square{static_cast<board::Line>(line_of(square)),
+			     static_cast<board::Column>(col_of(square))};
+}
+
+static Piece piece_of(char letter) {
+	switch (letter) {
+	case 'N':
+		return KNIGHT;
+	case 'B':
+		return BISHOP;
+	case 'R':
+		return ROOK;
+	case 'Q':
+		return QUEEN;
+	case 'K':
+		return KING;
+	default:
+		return PIECE_NONE;
+	}
+}
+
+static Piece piece_of(board::Piece piece) {
+	switch (piece) {
+	case board::PAWN:
+		return PAWN;
+	case board::KNIGHT:
+		return KNIGHT;
+	case board::BISHOP:
+		return BISHOP;
+	case board::ROOK:
+		return ROOK;
+	case board::QUEEN:
+		return QUEEN;
+	case board::KING:
+		return KING;
+	default:
+		return PIECE_NONE;
+	}
+}
+
+static char letter_of(Piece piece) {
+	switch (piece) {
+	case KNIGHT:
+		return 'N';
+	case BISHOP:
+		return 'B';
+	case ROOK:
+		return 'R';
+	case QUEEN:
+		return 'Q';
+	case KING:
+		return 'K';
+	default:
+		return '?';
+	}
+}
+
+static bool is_col(char c) { return 'a' <= c && c <= 'h'; }
+static bool is_line(char c) { return '1' <= c && c <= '8'; }
+static bool is_castle(char c) { return c == 'O' || c == '0'; }
+
+static bool parse_castling(std::string_view san, const Chessboard &chessboard,
+			   board::Move &move) {
+	bool queenside;
+	if (san.size() == 3 && is_castle(san[0]) && san[1] == '-' &&
+	    is_castle(san[2])) {
+		queenside = false;
+	} else if (san.size() == 5 && is_castle(san[0]) && san[1] == '-' &&
+		   is_castle(san[2]) && san[3] == '-' && is_castle(san[4])) {
+		queenside = true;
+	} else {
+		return false;
+	}
+
+	const Color c       = chessboard.get_turn();
+	const Square from   = c == WHITE ? SQ_E1 : SQ_E8;
+	const Square to     = Square(queenside ? from - 2 : from + 2);
+	const Bitboard king = chessboard.get_pieces(KING, c);
+
+	if (!(king & bb_of(from))) return false;
+	if (!(chessboard.get_legal_moves(from) & bb_of(to))) return false;
+
+	move = board::Move{to_board_square(from), to_board_square(to)};
+	return true;
+}
+
+bool parse_san(std::string_view san, const Chessboard &chessboard,
+	       board::Move &move) {
+	while (!san.empty() && (san.back() == '+' || san.back() == '#' ||
+				san.back() == '!' || san.back() == '?')) {
+		san.remove_suffix(1);
+	}
+	if (san.size() < 2) return false;
+	if (is_castle(san[0])) return parse_castling(san, chessboard, move);
+
+	Piece piece = piece_of(san[0]);
+	if (piece == PIECE_NONE) {
+		piece = PAWN;
+	} else {
+		san.remove_prefix(1);
+	}
+
+	board::Piece promotion = board::NO_PIECE;
+	if (san.size() >= 3 && parse_promotion(san.back()) != board::NO_PIECE &&
+	    (san[san.size() - 2] == '=' || is_line(san[san.size() - 2]))) {
+		promotion = parse_promotion(san.back());
+		san.remove_suffix(san[san.size() - 2] == '=' ? 2 : 1);
+	}
+
+	if (san.size() < 2) return false;
+	const char to_col  = san[san.size() - 2];
+	const char to_line = san[san.size() - 1];
+	if (!is_col(to_col) || !is_line(to_line)) return false;
+	const Square to = Square((to_col - 'a') + 8 * (to_line - '1'));
+	san.remove_suffix(2);
+
+	// What remains is the disambiguation, possibly followed by a capture
+	// or a dash
+	const bool has_capture = !san.empty() && san.back() == 'x';
+	if (!san.empty() && (san.back() == 'x' || san.back() == '-')) {
+		san.remove_suffix(1);
+	}
+	// a pawn without its column can only push on the column of the move
+	Bitboard origins = piece == PAWN && san.empty()
+			       ? bb_of(col_of(to))
+			       : ~BOARD_CLEAR;
+	for (const char c : san) {
+		if (is_col(c)) {
+			origins &= bb_of(Column(c - 'a'));
+		} else if (is_line(c)) {
+			origins &= bb_of(Line(c - '1'));
+		} else {
+			return false;
+		}
+	}
+
+	const Color c       = chessboard.get_turn();
+	Bitboard candidates = chessboard.get_pieces(piece, c) & origins;
+	Square from         = SQ_NONE;
+	while (candidates) {
+		const Square square = Square(pop_lsb(candidates));
+		if (!(chessboard.get_legal_moves(square) & bb_of(to))) continue;
+		// a second candidate means the move is ambiguous
+		if (from != SQ_NONE) return false;
+		from = square;
+	}
+	if (from == SQ_NONE) return false;
+
+	// a pawn changing column takes, en passant if the square is empty
+	const board::Square target = to_board_square(to);
+	const bool is_capture =
+	    (piece == PAWN && col_of(from) != col_of(to)) ||
+	    chessboard.get_piece(target).piece != board::NO_PIECE;
+	if (has_capture != is_capture) return false;
+
+	const bool is_promotion =
+	    piece == PAWN && (c == WHITE ? is_on_line<LINE_8>(to)
+					 : is_on_line<LINE_1>(to));
+	if (is_promotion != (promotion != board::NO_PIECE)) return false;
+
+	move = board::Move{to_board_square(from), to_board_square(to),
+			   promotion};
+	return true;
+}
+
+static Square to_square(board::Square square) {
+	return Square(square.col + 8 * square.line);
+}
+
+static char *write_square(Square square, char *out) {
+	*out++ = char('a' + col_of(square));
+	*out++ = char('1' + line_of(square));
+	return out;
+}
+
+size_t format_san(const Chessboard &chessboard, board::Move move, char *out) {
+	const Square from = to_square(move.from);
+	const Square to   = to_square(move.to);
+	const Color c     = chessboard.get_turn();
+	const Piece piece = piece_of(chessboard.get_piece(move.from).piece);
+	char *end         = out;
+
+	if (piece == KING && (to - from == 2 || from - to == 2)) {
+		const std::string_view castle = to > from ? "O-O" : "O-O-O";
+		for (const char letter : castle) *end++ = letter;
+		return end - out;
+	}
+
+	const bool is_capture =
+	    chessboard.get_piece(move.to).piece != board::NO_PIECE ||
+	    (piece == PAWN && col_of(from) != col_of(to));
+
+	if (piece == PAWN) {
+		if (is_capture) *end++ = char('a' + col_of(from));
+	} else {
+		*end++ = letter_of(piece);
+
+		Bitboard others =
+		    chessboard.get_pieces(piece, c) & ~bb_of(from);
+		Bitboard rivals = BOARD_CLEAR;
+		while (others) {
+			const Square other = Square(pop_lsb(others));
+			if (chessboard.get_legal_moves(other) & bb_of(to)) {
+				rivals |= bb_of(other);
+			}
+		}
+		if (rivals) {
+			if (!(rivals & bb_of(col_of(from)))) {
+				*end++ = char('a' + col_of(from));
+			} else if (!(rivals & bb_of(line_of(from)))) {
+				*end++ = char('1' + line_of(from));
+			} else {
+				end = write_square(from, end);
+			}
+		}
+	}
+	if (is_capture) *end++ = 'x';
+	end = write_square(to, end);
+
+	if (move.promotion != board::NO_PIECE) {
+		*end++ = '=';
+		*end++ = letter_of(piece_of(move.promotion));
+	}
+	return end - out;
+}
+
+size_t format_check(const Chessboard &chessboard, char *out) {
+	const GameState state = chessboard.get_game_state();
+	if (state == WHITE_CHECKMATE || state == BLACK_CHECKMATE) {
+		*out = '#';
+		return 1;
+	}
+	if (chessboard.is_check()) {
+		*out = '+';
+		return 1;
+	}
+	return 0;
+}
+}  // namespace notation
@@ -1,6 +1,5 @@
 #include "player/player_bot.hpp"
 
-#include <array>
 #include <iostream>
 #include <limits>
 #include <ostream>
@@ -11,31 +10,14 @@
 #include "board.hpp"
 #include "logic/chessboard.hpp"
 #include "player/player.hpp"
+#include "utils/cpu.hpp"
 
 using namespace board;
 
-// clang-format off
-std::array<int, 64> knight_heatmap = {
-    2, 3, 4, 4, 4, 4, 3, 2,
-    3, 4, 6, 6, 6, 6, 4, 3,
-    4, 6, 8, 8, 8, 8, 6, 4,
-    4, 6, 8, 8, 8, 8, 6, 4,
-    4, 6, 8, 8, 8, 8, 6, 4,
-    4, 6, 8, 8, 8, 8, 6, 4,
-    3, 4, 6, 6, 6, 6, 4, 3,
-    2, 3, 4, 4, 4, 4, 3, 2};
-std::array<int, 64> bishop_heatmap = {
-    7, 6, 5, 5, 5, 5, 6, 7,
-    6, 5, 4, 4, 4, 4, 5, 6,
-    5, 4, 3, 3, 3, 3, 4, 5,
-    5, 4, 3, 2, 2, 3, 4, 5,
-    5, 4, 3, 2, 2, 3, 4, 5,
-    5, 4, 3, 3, 3, 3, 4, 5,
-    6, 5, 4, 4, 4, 4, 5, 6,
-    7, 6, 5, 5, 5, 5, 6, 7};
-// clang-format on
-
-float evaluate(const Chessboard &chessboard) {
+// material value of each logic::Piece, the king is not counted
+constexpr int piece_values[] = {1, 5, 3, 3, 8, 0};
+
+CPU_DISPATCH float evaluate(const Chessboard &chessboard) {
 	GameState gs = chessboard.get_game_state();
 	switch (gs) {
 	case ONGOING:
@@ -45,53 +27,32 @@ float evaluate(const Chessboard &chessboard) {
 	case BLACK_CHECKMATE:
 		return -std::numeric_limits<float>::max();
 	case STALEMATE:
+	case REPETITION:
+	case FIFTY_MOVES:
+	case INSUFFICIENT_MATERIAL:
 		return 0;
 	}
 
-	float evaluation = 0;
-	Board board      = chessboard.to_array();
-	int square       = 0;
-
-	for (auto &line : board) {
-		for (auto &piece : line) {
-			int sign = piece.color == WHITE ? 1 : -1;
-			int score;
-			switch (piece.piece) {
-			case PAWN:
-				score = 1;
-				break;
-			case ROOK:
-				score = 5;
-				break;
-			case KNIGHT:
-				score =
-				    3 + (float)knight_heatmap[square] / 8 * 0.1;
-				break;
-			case BISHOP:
-				score =
-				    3 + (float)bishop_heatmap[square] / 8 * 0.1;
-				break;
-			case QUEEN:
-				score = 8;
-				break;
-			default:
-				score = 0;
-				break;
-			}
-			evaluation += sign * score;
-			square++;
-		}
+	int evaluation = 0;
+	for (int p = logic::PAWN; p <= logic::KING; p++) {
+		const logic::Piece piece = logic::Piece(p);
+		evaluation +=
+		    piece_values[p] *
+		    (popcount(chessboard.get_pieces(piece, logic::WHITE)) -
+		     popcount(chessboard.get_pieces(piece, logic::BLACK)));
 	}
 	return evaluation;
 }
 
-std::pair<Move, float> negaMax(Chessboard chessboard, int depth,
-			       bool is_player) {
+std::pair<Move, float> negaMax(const Chessboard &chessboard, int depth,
+			       bool is_player, double mobility) {
 	int sign = is_player ? 1 : -1;
 
-	if (depth == 0) return {Move(), sign * evaluate(chessboard)};
+	// the game is over on a checkmate but also on a draw
+	if (depth == 0 || chessboard.get_game_state() != ONGOING) {
+		return {Move(), sign * evaluate(chessboard)};
+	}
 	std::vector<Move> moves = chessboard.get_all_legal_moves();
-	if (moves.size() == 0) return {Move(), sign * evaluate(chessboard)};
 
 	Move best_move;
 	float best_score = -std::numeric_limits<float>::infinity();
@@ -99,11 +60,13 @@ std::pair<Move, float> negaMax(Chessboard chessboard, int depth,
 	for (auto &move : moves) {
 		Chessboard new_chessboard = chessboard;
 		new_chessboard.make_move(move);
-		float complexity =
-		    (float)new_chessboard.get_legal_move_count() / 200 * 0.01;
-		float score =
-		    -negaMax(new_chessboard, depth - 1, !is_player).second -
-		    complexity;
+		const unsigned int replies =
+		    new_chessboard.get_legal_move_count();
+		float complexity = (float)replies / 200 * mobility;
+		float reply = negaMax(new_chessboard, depth - 1, !is_player,
+				      mobility)
+				  .second;
+		float score = -reply - complexity;
 
 		if (score > best_score) {
 			best_score = score;
@@ -121,14 +84,18 @@ void Player_bot::start_new_game(bool is_white) {
 	this->is_started = true;
 }
 
-Player_move Player_bot::play(Chessboard chessboard) {
-	Move move = negaMax(chessboard, this->max_depth, is_white).first;
-	std::cout << move.from.to_string() << " " << move.to.to_string()
-		  << std::endl;
+Player_move Player_bot::play(const Chessboard &chessboard) {
+	// the positions searched are copies of this one, sharing its cache
+	Chessboard root = chessboard;
+	root.set_cache(cache.get());
+	Move move =
+	    negaMax(root, params.depth, is_white, params.mobility).first;
+	out << move.from.to_string() << " " << move.to.to_string()
+	    << std::endl;
 	return {PLAY, move};
 }
 
-Player_move Player_bot::invalid_move(Chessboard chessboard) {
+Player_move Player_bot::invalid_move(const Chessboard &chessboard) {
 	(void)chessboard;
 	throw std::runtime_error("Unexpected invalid_move");
 }
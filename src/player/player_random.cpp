@@ -10,13 +10,13 @@ void Player_random::start_new_game(bool is_white) {
 	this->is_started = true;
 }
 
-Player_move Player_random::play(Chessboard chessboard) {
+Player_move Player_random::play(const Chessboard &chessboard) {
 	std::vector<board::Move> moves = chessboard.get_all_legal_moves();
 	std::uniform_int_distribution<> distribution(0, moves.size() - 1);
 	return Player_move{PLAY, moves[distribution(generator)]};
 }
 
-Player_move Player_random::invalid_move(Chessboard chessboard) {
+Player_move Player_random::invalid_move(const Chessboard &chessboard) {
 	(void)chessboard;
 	throw std::runtime_error("Unexpected invalid_move");
 }
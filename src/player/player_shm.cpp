@@ -0,0 +1,51 @@
+#include "player/player_shm.hpp"
+
+using namespace net;
+
+void Player_shm::start_new_game(bool is_white) {
+	Frame frame;
+	frame.type         = START;
+	frame.game         = ++game;
+	frame.action       = is_white ? logic::WHITE : logic::BLACK;
+	frame.time_left_ms = timeout.count();
+	channel.send(frame);
+}
+
+Player_move Player_shm::request(const Chessboard &chessboard,
+				Frame_type type) {
+	Frame frame;
+	frame.type         = type;
+	frame.game         = game;
+	frame.sequence     = chessboard.get_turn_count();
+	frame.move         = chessboard.get_last_move();
+	frame.time_left_ms = timeout.count();
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	if (!channel.send(frame)) return {RESIGN, {}};
+
+	Frame answer;
+	while (channel.receive(answer, deadline)) {
+		// an answer to an older request came too late
+		if (answer.type != MOVE || answer.game != game ||
+		    answer.sequence != frame.sequence) {
+			continue;
+		}
+		if (!is_valid_answer(answer)) break;
+		return {Action(answer.action), answer.move};
+	}
+	return {RESIGN, {}};
+}
+
+Player_move Player_shm::play(const Chessboard &chessboard) {
+	return request(chessboard, YOUR_TURN);
+}
+
+Player_move Player_shm::invalid_move(const Chessboard &chessboard) {
+	return request(chessboard, INVALID);
+}
+
+void Player_shm::end() {
+	Frame frame;
+	frame.type = GAME_OVER;
+	frame.game = game;
+	channel.send(frame);
+}
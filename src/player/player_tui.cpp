@@ -1,10 +1,9 @@
 #include "player/player_tui.hpp"
 
-#include <iostream>
-#include <regex>
 #include <stdexcept>
 
 #include "board.hpp"
+#include "notation/move_parser.hpp"
 
 using namespace std;
 using namespace board;
@@ -14,53 +13,7 @@ void Player_tui::start_new_game(bool is_white) {
 	is_started     = true;
 }
 
-Piece parse_piece(char input) {
-	switch (input) {
-	case 'N':
-	case 'n':
-		return board::KNIGHT;
-	case 'R':
-	case 'r':
-		return board::ROOK;
-	case 'B':
-	case 'b':
-		return board::BISHOP;
-	case 'Q':
-	case 'q':
-		return board::QUEEN;
-	case 'K':
-	case 'k':
-		return board::KING;
-	case 'P':
-	case 'p':
-		return board::PAWN;
-	default:
-		return board::NO_PIECE;
-	}
-}
-
-bool Player_tui::parse_move(string input, Move& move) {
-	regex king_side_castle("(O|o|0)-(O|o|0)");
-	regex queen_side_castle("(O|o|0)-(O|o|0)-(O|o|0)");
-	regex movement("[a-h][1-8][a-h][1-8]");
-	regex movement_with_promotion("[a-h][1-8][a-h][1-8][RrBbNnQq]");
-
-	if (regex_match(input, movement)) {
-		move.from = Square(input.substr(0, 2));
-		move.to   = Square(input.substr(2, 2));
-	} else if (regex_match(input, king_side_castle)) {
-		move.from = is_white ? Square("e1") : Square("e8");
-		move.to   = is_white ? Square("g1") : Square("g8");
-	} else if (regex_match(input, queen_side_castle)) {
-		move.from = is_white ? Square("e1") : Square("e8");
-		move.to   = is_white ? Square("c1") : Square("c8");
-	} else {
-		return false;
-	}
-	return true;
-}
-
-Player_move Player_tui::play(Chessboard chessboard) {
+Player_move Player_tui::play(const Chessboard &chessboard) {
 	if (!is_started) {
 		throw runtime_error(
 		    "Player_tui::play() called before "
@@ -68,11 +21,15 @@ Player_move Player_tui::play(Chessboard chessboard) {
 	}
 
 	Player_move player_move;
-	Move& move = player_move.move;
-	cout << "Coup (eg. a1a8) ? ";
+	Move& move        = player_move.move;
+	const Color color = is_white ? WHITE : BLACK;
+	out << "Coup (eg. a1a8) ? ";
+	string input;
 	while (true) {
-		string input;
-		cin >> input;
+		if (!(in >> input)) {
+			player_move.action = END;
+			break;
+		}
 
 		if (input == "/resign") {
 			player_move.action = RESIGN;
@@ -83,21 +40,21 @@ Player_move Player_tui::play(Chessboard chessboard) {
 		} else if (input == "/draw") {
 			player_move.action = DRAW;
 			break;
-		} else if (parse_move(input, move)) {
+		} else if (notation::parse_move(input, color, move)) {
 			player_move.action = PLAY;
 
-			cout << "move: " << move.from.to_string()
-			     << move.to.to_string() << endl;
+			out << "move: " << move.from.to_string()
+			    << move.to.to_string() << endl;
 
 			Colored_piece piece = chessboard.get_piece(move.from);
-			if (piece.piece == PAWN &&
-			    piece.color == (is_white ? WHITE : BLACK) &&
+			if (piece.piece == PAWN && piece.color == color &&
+			    move.promotion == NO_PIECE &&
 			    move.to.line == (is_white ? LINE_8 : LINE_1)) {
-				cout << "Promotion (N, B, R, Q) ? ";
-				string input;
-				cin >> input;
-				cout << "input: " << input << endl;
-				move.promotion = parse_piece(input[0]);
+				out << "Promotion (N, B, R, Q) ? ";
+				in >> input;
+				out << "input: " << input << endl;
+				move.promotion =
+				    notation::parse_promotion(input[0]);
 			}
 			break;
 		} else {
@@ -107,14 +64,14 @@ Player_move Player_tui::play(Chessboard chessboard) {
 	return player_move;
 }
 
-Player_move Player_tui::invalid_move(Chessboard chessboard) {
+Player_move Player_tui::invalid_move(const Chessboard &chessboard) {
 	if (!is_started) {
 		throw runtime_error(
 		    "Player_tui::invalid_move() called before "
 		    "Player_tui::start_new_game()");
 	}
 
-	cout << "Illegal move" << endl;
+	out << "Illegal move" << endl;
 	return play(chessboard);
 }
 
@@ -0,0 +1,349 @@
+#include "tools/bench.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "logic/chessboard.hpp"
+#include "logic/move_cache.hpp"
+#include "logic/slider_kernel.hpp"
+#include "player/player_bot.hpp"
+#include "utils/cpu.hpp"
+
+using namespace std;
+using namespace logic;
+
+struct Reference {
+	const char *name;
+	// board::from_string layout, white to move, the initial board if null
+	const char *layout;
+	vector<uint64_t> nodes;
+};
+
+// clang-format off
+static const Reference references[] = {
+    {"start", nullptr, {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete",
+     "wR,,,,wK,,,wR,wP,wP,wP,wB,wB,wP,wP,wP,,,wN,,,wQ,,bP,,bP,,,wP,,,,,,,wP,"
+     "wN,,,,bB,bN,,,bP,bN,bP,,bP,,bP,bP,bQ,bP,bB,,bR,,,,bK,,,bR,",
+     {48, 2039, 97862, 4085603, 193690690}},
+    {"endgame",
+     ",,,,,,,,,,,,wP,,wP,,,,,,,,,,,wR,,,,bP,,bK,wK,wP,,,,,,bR,,,,bP,,,,,,,bP,"
+     ",,,,,,,,,,,,,",
+     {14, 191, 2812, 43238, 674624, 11030083}},
+    {"promotions",
+     "wR,,,wQ,,wR,wK,,wP,bP,,wP,,,wP,wP,bQ,,,,,wN,,,wB,wB,wP,,wP,,,,bN,wP,,,,"
+     ",,,,bB,,,,bN,bB,wN,wP,bP,bP,bP,,bP,bP,bP,bR,,,,bK,,,bR,",
+     {6, 264, 9467, 422333, 15833292}},
+};
+// clang-format on
+
+using Clock = chrono::steady_clock;
+
+static Chessboard make_chessboard(const Reference &reference) {
+	if (reference.layout == nullptr) return Chessboard();
+	return Chessboard(board::from_string(reference.layout));
+}
+
+static uint64_t perft(const Chessboard &chessboard, int depth) {
+	if (depth == 1) return chessboard.get_legal_move_count();
+	uint64_t nodes = 0;
+	for (const auto &move : chessboard.get_all_legal_moves()) {
+		Chessboard child = chessboard;
+		child.make_move(move);
+		nodes += perft(child, depth - 1);
+	}
+	return nodes;
+}
+
+static void collect(const Chessboard &chessboard, int depth,
+		    vector<Position> &positions) {
+	positions.push_back(chessboard.get_position());
+	if (depth == 0) return;
+	for (const auto &move : chessboard.get_all_legal_moves()) {
+		Chessboard child = chessboard;
+		child.make_move(move);
+		collect(child, depth - 1, positions);
+	}
+}
+
+// the chessboard rebuilt from its compact position is the same one, and
+// gives_check agrees with the position after the move
+static bool check(const Chessboard &chessboard, int depth) {
+	const Chessboard rebuilt(chessboard.get_position());
+	if (!rebuilt.is_same_as(chessboard) ||
+	    rebuilt.get_key() != chessboard.get_key() ||
+	    rebuilt.get_legal_move_count() !=
+		chessboard.get_legal_move_count()) {
+		return false;
+	}
+	if (depth == 0) return true;
+	for (const auto &move : chessboard.get_all_legal_moves()) {
+		Chessboard child = chessboard;
+		child.make_move(move);
+		if (chessboard.gives_check(move) != child.is_check() ||
+		    !check(child, depth - 1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool bench_check(int depth) {
+	bool is_ok = true;
+	for (const auto &reference : references) {
+		const bool is_consistent =
+		    check(make_chessboard(reference), depth);
+		is_ok &= is_consistent;
+		cout << "check " << setw(10) << left << reference.name << right
+		     << " depth " << depth << " positions and checks "
+		     << (is_consistent ? "OK" : "FAIL") << endl;
+	}
+	return is_ok;
+}
+
+static bool bench_perft(int depth, vector<Position> &positions) {
+	bool is_ok = true;
+	for (const auto &reference : references) {
+		const int max_depth = int(reference.nodes.size());
+		const int used      = depth < max_depth ? depth : max_depth;
+		const Chessboard chessboard = make_chessboard(reference);
+		collect(chessboard, 2, positions);
+
+		const auto start     = Clock::now();
+		const uint64_t nodes = perft(chessboard, used);
+		const chrono::duration<double> elapsed = Clock::now() - start;
+
+		const bool is_expected = nodes == reference.nodes[used - 1];
+		is_ok &= is_expected;
+		cout << "perft " << setw(10) << left << reference.name << right
+		     << " depth " << used << setw(12) << nodes << " nodes "
+		     << setw(8) << elapsed.count() << " s " << setw(8)
+		     << nodes / elapsed.count() / 1e6 << " Mnps "
+		     << (is_expected ? "OK" : "FAIL") << endl;
+		if (!is_expected) {
+			cout << "    expected " << reference.nodes[used - 1]
+			     << endl;
+		}
+	}
+	return is_ok;
+}
+
+// the same perft with a move cache, the transpositions skip the generation
+static bool bench_cache(int depth) {
+	bool is_ok = true;
+	Move_cache cache(1 << 16);
+	for (const auto &reference : references) {
+		const int max_depth = int(reference.nodes.size());
+		const int used      = depth < max_depth ? depth : max_depth;
+		Chessboard chessboard = make_chessboard(reference);
+		cache.clear();
+		chessboard.set_cache(&cache);
+
+		const auto start     = Clock::now();
+		const uint64_t nodes = perft(chessboard, used);
+		const chrono::duration<double> elapsed = Clock::now() - start;
+
+		const bool is_expected = nodes == reference.nodes[used - 1];
+		is_ok &= is_expected;
+		cout << "cached " << setw(10) << left << reference.name << right
+		     << " depth " << used << setw(12) << nodes << " nodes "
+		     << setw(8) << elapsed.count() << " s " << setw(8)
+		     << 100 * cache.get_hit_rate() << " % hits "
+		     << (is_expected ? "OK" : "FAIL") << endl;
+	}
+	return is_ok;
+}
+
+// a few moves of the bot against itself from each reference, the moves found
+// with the cache must be the same
+static bool bench_bot(int depth) {
+	constexpr int plies = 8;
+	const size_t sizes[] = {0, 1 << 14};
+	vector<board::Move> played[2];
+	for (int i = 0; i < 2; i++) {
+		ostringstream out;
+		Bot_params params;
+		params.depth = depth;
+		params.cache = sizes[i];
+		Player_bot bot(params, out);
+		const auto start = Clock::now();
+		for (const auto &reference : references) {
+			Chessboard chessboard = make_chessboard(reference);
+			bot.start_new_game(true);
+			int ply = 0;
+			while (ply++ < plies &&
+			       chessboard.get_game_state() == ONGOING) {
+				const board::Move move =
+				    bot.play(chessboard).move;
+				chessboard.make_move(move);
+				played[i].push_back(move);
+			}
+			bot.end();
+		}
+		const chrono::duration<double> elapsed = Clock::now() - start;
+		cout << "bot depth " << depth << ", cache of " << setw(6)
+		     << sizes[i] << " entries " << setw(8) << elapsed.count()
+		     << " s" << endl;
+	}
+	bool is_ok = played[0].size() == played[1].size();
+	for (size_t i = 0; is_ok && i < played[0].size(); i++) {
+		const board::Move &a = played[0][i];
+		const board::Move &b = played[1][i];
+		is_ok = a.from.to_string() == b.from.to_string() &&
+			a.to.to_string() == b.to.to_string() &&
+			a.promotion == b.promotion;
+	}
+	if (!is_ok) cout << "bot moves differ with the cache" << endl;
+	return is_ok;
+}
+
+// --- Slider attack generators, the union of the attacks of the sliders of
+// the side to move ---
+struct Sliders {
+	Bitboard straight;
+	Bitboard diagonal;
+	Bitboard occupied;
+};
+
+static Sliders sliders_of(const Position &position) {
+	const Bitboard own   = position.color[position.turn];
+	const Bitboard queen = position.pieces[QUEEN];
+	return {(position.pieces[ROOK] | queen) & own,
+		(position.pieces[BISHOP] | queen) & own,
+		position.color[WHITE] | position.color[BLACK]};
+}
+
+// one slider and one direction at a time, with the ray functions of the
+// attack map, which keeps one set per piece instead of their union
+static Bitboard ray_generator(const Sliders &sliders) {
+	Bitboard attacks  = BOARD_CLEAR;
+	Bitboard straight = sliders.straight;
+	while (straight) {
+		const Square square = static_cast<Square>(pop_lsb(straight));
+		attacks |= rook_attacks(square, sliders.occupied);
+	}
+	Bitboard diagonal = sliders.diagonal;
+	while (diagonal) {
+		const Square square = static_cast<Square>(pop_lsb(diagonal));
+		attacks |= bishop_attacks(square, sliders.occupied);
+	}
+	return attacks;
+}
+
+// the ray from the square, minus the ray from its first blocker
+template <Direction d>
+inline Bitboard table_ray(Square square, Bitboard occupied) {
+	const Bitboard ray      = RAY[d][square] & ~bb_of(square);
+	const Bitboard blockers = ray & occupied;
+	if (!blockers) return ray;
+	const Square blocker =
+	    Square(d % 2 == 0 ? lsb(blockers) : msb(blockers));
+	return ray & ~(RAY[d][blocker] & ~bb_of(blocker));
+}
+
+static Bitboard table_generator(const Sliders &sliders) {
+	const Bitboard occupied = sliders.occupied;
+	Bitboard attacks        = BOARD_CLEAR;
+	Bitboard straight       = sliders.straight;
+	while (straight) {
+		const Square square = static_cast<Square>(pop_lsb(straight));
+		attacks |= table_ray<NORTH>(square, occupied) |
+			   table_ray<SOUTH>(square, occupied) |
+			   table_ray<EAST>(square, occupied) |
+			   table_ray<WEST>(square, occupied);
+	}
+	Bitboard diagonal = sliders.diagonal;
+	while (diagonal) {
+		const Square square = static_cast<Square>(pop_lsb(diagonal));
+		attacks |= table_ray<NORTH_EAST>(square, occupied) |
+			   table_ray<NORTH_WEST>(square, occupied) |
+			   table_ray<SOUTH_EAST>(square, occupied) |
+			   table_ray<SOUTH_WEST>(square, occupied);
+	}
+	return attacks;
+}
+
+static Bitboard scalar_generator(const Sliders &sliders) {
+	return slider_attacks_scalar(sliders.straight, sliders.diagonal,
+				     ~sliders.occupied);
+}
+
+static Bitboard avx2_generator(const Sliders &sliders) {
+	return slider_attacks_avx2(sliders.straight, sliders.diagonal,
+				   ~sliders.occupied);
+}
+
+struct Generator {
+	const char *name;
+	Bitboard (*generate)(const Sliders &);
+};
+
+static bool bench_sliders(const vector<Position> &positions) {
+	vector<Sliders> inputs;
+	for (const auto &position : positions) {
+		inputs.push_back(sliders_of(position));
+	}
+
+	vector<Generator> generators = {{"rays", ray_generator},
+					{"tables", table_generator},
+					{"kogge-stone", scalar_generator}};
+	if (has_avx2()) {
+		generators.push_back({"kogge-stone avx2", avx2_generator});
+	}
+
+	bool is_ok = true;
+	for (const auto &input : inputs) {
+		const Bitboard expected = ray_generator(input);
+		for (const auto &generator : generators) {
+			is_ok &= generator.generate(input) == expected;
+		}
+	}
+
+	constexpr int rounds = 200;
+	cout << "union of the slider attacks (not used by the engine), "
+	     << inputs.size() << " positions x " << rounds << endl;
+	for (const auto &generator : generators) {
+		Bitboard checksum = BOARD_CLEAR;
+		const auto start  = Clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (const auto &input : inputs) {
+				checksum += generator.generate(input);
+			}
+		}
+		const chrono::duration<double, nano> elapsed =
+		    Clock::now() - start;
+		cout << "    " << setw(18) << left << generator.name << right
+		     << setw(8)
+		     << elapsed.count() / double(rounds * inputs.size())
+		     << " ns/position (checksum " << hex << checksum << dec
+		     << ")" << endl;
+	}
+	if (!is_ok) cout << "slider generators disagree" << endl;
+	return is_ok;
+}
+
+static void print_cpu() {
+	const Cpu_features &cpu = cpu_features();
+	cout << "cpu:" << (cpu.popcnt ? " popcnt" : "")
+	     << (cpu.bmi2 ? " bmi2" : "") << (cpu.avx2 ? " avx2" : "")
+	     << ", make_move and evaluate: " << cpu_dispatch_level()
+	     << endl;
+}
+
+int bench(int depth) {
+	cout << fixed << setprecision(3);
+	print_cpu();
+	vector<Position> positions;
+	const bool is_perft_ok  = bench_perft(depth, positions);
+	const bool is_cache_ok  = bench_cache(depth);
+	const bool is_check_ok  = bench_check(depth < 3 ? depth : 3);
+	const bool is_bot_ok    = bench_bot(depth < 3 ? depth : 3);
+	const bool is_slider_ok = bench_sliders(positions);
+	const bool is_ok        = is_perft_ok && is_cache_ok && is_check_ok &&
+			   is_bot_ok && is_slider_ok;
+	return is_ok ? 0 : 1;
+}
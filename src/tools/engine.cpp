@@ -0,0 +1,215 @@
+#include "tools/engine.hpp"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "net/shm_channel.hpp"
+#include "tools/host.hpp"
+
+using namespace std;
+using namespace net;
+using Clock = chrono::steady_clock;
+
+int engine(const string &name, const string &type) {
+	ostream null(nullptr);
+	const unique_ptr<Player> player = make_player(type, null);
+
+	// the other process may not have created the channel yet
+	unique_ptr<Shm_channel> channel;
+	const Clock::time_point give_up = Clock::now() + chrono::seconds(5);
+	while (!channel) {
+		try {
+			channel = make_unique<Shm_channel>(name, false);
+		} catch (const runtime_error &e) {
+			if (Clock::now() >= give_up) {
+				cerr << e.what() << endl;
+				return 1;
+			}
+			this_thread::sleep_for(chrono::milliseconds(10));
+		}
+	}
+
+	Chessboard chessboard;
+	Frame frame;
+	while (channel->receive(frame, Clock::now() + chrono::hours(24))) {
+		if (frame.type == START) {
+			chessboard = Chessboard();
+			player->start_new_game(frame.action == logic::WHITE);
+		} else if (frame.type == YOUR_TURN || frame.type == INVALID) {
+			if (frame.sequence == chessboard.get_turn_count() + 1) {
+				chessboard.make_move(frame.move);
+			}
+			const Player_move answer =
+			    frame.type == YOUR_TURN
+				? player->play(chessboard)
+				: player->invalid_move(chessboard);
+			// a refused move doesn't change the position either
+			if (answer.action == PLAY) {
+				chessboard.make_move(answer.move);
+			}
+			frame.type   = MOVE;
+			frame.action = answer.action;
+			frame.move   = answer.move;
+			channel->send(frame);
+		} else if (frame.type == GAME_OVER) {
+			player->end();
+		}
+	}
+	return 0;
+}
+
+static void print_latency(const char *transport, vector<double> &samples) {
+	sort(samples.begin(), samples.end());
+	double total = 0;
+	for (const double sample : samples) total += sample;
+	cout << transport << ": mean " << total / samples.size()
+	     << " us, median " << samples[samples.size() / 2] << " us, p99 "
+	     << samples[samples.size() * 99 / 100] << " us, max "
+	     << samples.back() << " us" << endl;
+}
+
+// time frames sent by send and answered through receive
+template <typename Send, typename Receive>
+static vector<double> time_round_trips(size_t round_trips, Send send,
+				       Receive receive) {
+	vector<double> samples;
+	samples.reserve(round_trips);
+	Frame frame;
+	for (size_t i = 0; i < round_trips; i++) {
+		frame.sequence               = i;
+		const Clock::time_point sent = Clock::now();
+		Frame answer;
+		if (!send(frame) || !receive(answer) ||
+		    answer.sequence != frame.sequence) {
+			throw runtime_error("The echo process didn't answer");
+		}
+		const chrono::duration<double, micro> elapsed =
+		    Clock::now() - sent;
+		samples.push_back(elapsed.count());
+	}
+	frame.type = GAME_OVER;
+	send(frame);
+	return samples;
+}
+
+static vector<double> bench_shm(size_t round_trips) {
+	const string name = "/chess_project-bench-" + to_string(getpid());
+	Shm_channel channel(name, true);
+	const pid_t child = fork();
+	if (child < 0) throw runtime_error("Can't fork");
+	if (child == 0) {
+		{
+			Shm_channel echo(name, false);
+			const auto timeout = chrono::seconds(5);
+			Frame frame;
+			while (echo.receive(frame, Clock::now() + timeout) &&
+			       frame.type != GAME_OVER) {
+				frame.type = MOVE;
+				echo.send(frame);
+			}
+		}
+		_exit(0);
+	}
+	vector<double> samples = time_round_trips(
+	    round_trips,
+	    [&](const Frame &frame) { return channel.send(frame); },
+	    [&](Frame &frame) {
+		    return channel.receive(frame,
+					   Clock::now() + chrono::seconds(5));
+	    });
+	waitpid(child, nullptr, 0);
+	return samples;
+}
+
+static bool send_frame(int fd, const Frame &frame) {
+	vector<uint8_t> bytes;
+	encode(frame, bytes);
+	return ::send(fd, bytes.data(), bytes.size(), MSG_NOSIGNAL) ==
+	       ssize_t(bytes.size());
+}
+
+static bool receive_frame(int fd, vector<uint8_t> &input, Frame &frame) {
+	while (true) {
+		size_t consumed;
+		const Decode_status status =
+		    decode(input.data(), input.size(), frame, consumed);
+		if (status == DECODED) {
+			input.erase(input.begin(), input.begin() + consumed);
+			return true;
+		}
+		uint8_t buffer[256];
+		const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+		if (status == MALFORMED || received <= 0) return false;
+		input.insert(input.end(), buffer, buffer + received);
+	}
+}
+
+static vector<double> bench_tcp(size_t round_trips) {
+	sockaddr_in address{};
+	address.sin_family      = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length        = sizeof(address);
+	const int listener      = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0 || bind(listener, (sockaddr *)&address, length) < 0 ||
+	    listen(listener, 1) < 0 ||
+	    getsockname(listener, (sockaddr *)&address, &length) < 0) {
+		throw runtime_error("Can't listen on the loopback interface");
+	}
+	const int no_delay = 1;
+	const pid_t child  = fork();
+	if (child < 0) throw runtime_error("Can't fork");
+	if (child == 0) {
+		::close(listener);
+		const int fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (connect(fd, (sockaddr *)&address, length) < 0) _exit(1);
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+			   sizeof(no_delay));
+		vector<uint8_t> input;
+		Frame frame;
+		while (receive_frame(fd, input, frame) &&
+		       frame.type != GAME_OVER) {
+			frame.type = MOVE;
+			send_frame(fd, frame);
+		}
+		_exit(0);
+	}
+	const int fd = accept(listener, nullptr, nullptr);
+	::close(listener);
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	vector<uint8_t> input;
+	vector<double> samples = time_round_trips(
+	    round_trips,
+	    [&](const Frame &frame) { return send_frame(fd, frame); },
+	    [&](Frame &frame) { return receive_frame(fd, input, frame); });
+	::close(fd);
+	waitpid(child, nullptr, 0);
+	return samples;
+}
+
+int transport_bench(size_t round_trips) {
+	if (round_trips == 0) round_trips = 1;
+	cout << fixed << setprecision(2);
+	cout << round_trips << " round trips of " << FRAME_SIZE
+	     << "-byte frames between two processes" << endl;
+	vector<double> shm = bench_shm(round_trips);
+	print_latency("shared memory", shm);
+	vector<double> tcp = bench_tcp(round_trips);
+	print_latency("loopback TCP ", tcp);
+	cout << "median speedup " << tcp[tcp.size() / 2] / shm[shm.size() / 2]
+	     << "x" << endl;
+	return 0;
+}
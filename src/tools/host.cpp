@@ -0,0 +1,62 @@
+#include "tools/host.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "controller/game_scheduler.hpp"
+#include "player/player_bot.hpp"
+#include "player/player_random.hpp"
+#include "tools/match.hpp"
+
+using namespace std;
+
+unique_ptr<Player> make_player(const string &type, ostream &out) {
+	if (type == "random") return make_unique<Player_random>();
+	if (type == "bot") return make_unique<Player_bot>(Bot_params{}, out);
+	if (type.rfind("bot:", 0) == 0) {
+		return make_unique<Player_bot>(parse_bot_params(type.substr(4)),
+					       out);
+	}
+	throw invalid_argument("Invalid player type " + type);
+}
+
+int host(size_t games, size_t threads, const string &white,
+	 const string &black) {
+	size_t results[3] = {0, 0, 0};
+	// one silent stream per game, the bots write their moves to it
+	vector<unique_ptr<ostream>> streams;
+
+	const auto start = chrono::steady_clock::now();
+	Game_scheduler scheduler(threads);
+	scheduler.set_on_finished([&](size_t, const Controller &controller) {
+		const GameState state =
+		    controller.get_chessboard().get_game_state();
+		results[state == WHITE_CHECKMATE   ? 0
+			: state == BLACK_CHECKMATE ? 2
+						   : 1]++;
+	});
+	for (size_t i = 0; i < games; i++) {
+		streams.push_back(make_unique<ostream>(nullptr));
+		ostream &out = *streams.back();
+		scheduler.add(make_unique<Controller>(make_player(white, out),
+						      make_player(black, out)));
+	}
+	scheduler.wait();
+	const chrono::duration<double> elapsed =
+	    chrono::steady_clock::now() - start;
+
+	const Scheduler_stats stats = scheduler.get_stats();
+	cout << fixed << setprecision(3);
+	cout << stats.finished << " games in " << elapsed.count() << " s on "
+	     << threads << " workers, white +" << results[0] << " ="
+	     << results[1] << " -" << results[2] << endl;
+	cout << stats.steps << " steps, queue depth max "
+	     << stats.max_queue_depth << ", latency mean "
+	     << stats.mean_latency_ms << " ms max " << stats.max_latency_ms
+	     << " ms, game mean " << stats.mean_game_ms << " ms" << endl;
+	return 0;
+}
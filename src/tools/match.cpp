@@ -0,0 +1,243 @@
+#include "tools/match.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "controller/controller.hpp"
+#include "notation/san.hpp"
+#include "utils/thread_pool.hpp"
+
+using namespace std;
+
+using Opening = vector<string>;
+
+// main replies to the main first moves, balanced enough for both sides
+static const char *const default_openings[] = {
+    "e4 e5",       "e4 c5",         "e4 e6",          "e4 c6",
+    "e4 d5",       "d4 d5",         "d4 Nf6",         "c4 e5",
+    "Nf3 d5",      "d4 Nf6 c4 e6",  "e4 e5 Nf3 Nc6",  "d4 d5 c4 c6",
+};
+
+Bot_params parse_bot_params(const string &text) {
+	Bot_params params;
+	istringstream in(text);
+	char separator;
+	const bool is_valid = in >> params.depth && params.depth >= 1;
+	if (!is_valid ||
+	    (in >> separator &&
+	     (separator != ':' || !(in >> params.mobility))) ||
+	    (in >> separator &&
+	     (separator != ':' || !(in >> params.cache)))) {
+		throw invalid_argument(
+		    "Bot parameters must be depth[:mobility[:cache]]");
+	}
+	return params;
+}
+
+static Opening split_moves(const string &line) {
+	Opening opening;
+	istringstream in(line);
+	string token;
+	while (in >> token) {
+		// move numbers such as "1." are allowed
+		if (token.back() == '.') continue;
+		opening.push_back(token);
+	}
+	return opening;
+}
+
+static vector<Opening> load_openings(const string &path) {
+	vector<Opening> openings;
+	if (path.empty()) {
+		for (const char *line : default_openings) {
+			openings.push_back(split_moves(line));
+		}
+		return openings;
+	}
+	ifstream file(path);
+	if (!file) throw runtime_error("Can't open " + path);
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		openings.push_back(split_moves(line));
+	}
+	if (openings.empty()) throw runtime_error("No opening in " + path);
+	return openings;
+}
+
+static Chessboard play_opening(const Opening &opening) {
+	Chessboard chessboard;
+	for (const auto &san : opening) {
+		board::Move move;
+		if (!notation::parse_san(san, chessboard, move) ||
+		    !chessboard.make_move(move)) {
+			throw invalid_argument("Invalid opening move " + san);
+		}
+	}
+	return chessboard;
+}
+
+// games counted from the side of the engine A
+struct Tally {
+	size_t wins   = 0;
+	size_t draws  = 0;
+	size_t losses = 0;
+
+	size_t games() const { return wins + draws + losses; };
+	double score() const {
+		return (wins + 0.5 * draws) / double(games());
+	};
+	// variance of the result of one game
+	double variance() const {
+		const double x = score();
+		const double sum = wins * (1 - x) * (1 - x) +
+				   draws * (0.5 - x) * (0.5 - x) +
+				   losses * x * x;
+		return sum / double(games());
+	};
+};
+
+static double elo_of(double score) { return -400 * log10(1 / score - 1); }
+
+static double score_of(double elo) {
+	return 1 / (1 + pow(10, -elo / 400));
+}
+
+// log-likelihood ratio of H1 (elo1) against H0 (elo0), the mean result
+// of a game following a normal law
+static double llr(const Tally &tally, double elo0, double elo1) {
+	if (tally.games() == 0) return 0;
+	// games all ending the same way would make the ratio infinite, the
+	// variance is at least the one of a single draw among them
+	const double variance =
+	    max(tally.variance(), 0.25 / double(tally.games() + 1));
+	const double s0 = score_of(elo0);
+	const double s1 = score_of(elo1);
+	return (s1 - s0) * (2 * tally.score() - s0 - s1) * tally.games() /
+	       (2 * variance);
+}
+
+static void print_elo(const Tally &tally) {
+	const double score = tally.score();
+	if (score <= 0 || score >= 1) {
+		cout << "elo " << (score <= 0 ? "-inf" : "+inf");
+		return;
+	}
+	// 95 % interval of the score
+	const double margin = 1.96 * sqrt(tally.variance() / tally.games());
+	cout << "elo " << showpos << elo_of(score) << noshowpos;
+	if (score - margin > 0 && score + margin < 1) {
+		cout << " +- "
+		     << (elo_of(score + margin) - elo_of(score - margin)) / 2;
+	}
+}
+
+// 1 if A won, 0 for a draw, -1 if A lost
+static int game_result(GameState state, bool is_a_white) {
+	int white_result = 0;
+	if (state == WHITE_CHECKMATE) white_result = 1;
+	if (state == BLACK_CHECKMATE) white_result = -1;
+	return is_a_white ? white_result : -white_result;
+}
+
+int match(const Match_options &options) {
+	vector<Opening> openings;
+	try {
+		openings = load_openings(options.openings);
+		for (const auto &opening : openings) play_opening(opening);
+	} catch (const exception &e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	const double lower = log(options.beta / (1 - options.alpha));
+	const double upper = log((1 - options.beta) / options.alpha);
+
+	mutex tally_mutex;
+	Tally tally;
+	double ratio = 0;
+	atomic<bool> is_decided(false);
+
+	cout << fixed << setprecision(1);
+	const auto start = chrono::steady_clock::now();
+	{
+		Thread_pool pool(options.threads);
+		for (size_t i = 0; i < options.games; i++) {
+			pool.submit([&, i] {
+				if (is_decided) return;
+				const bool is_a_white = i % 2 == 0;
+				const Bot_params &white =
+				    options.engines[is_a_white ? 0 : 1];
+				const Bot_params &black =
+				    options.engines[is_a_white ? 1 : 0];
+				ostream null(nullptr);
+				Controller controller(
+				    make_unique<Player_bot>(white, null),
+				    make_unique<Player_bot>(black, null),
+				    play_opening(openings[(i / 2) %
+							  openings.size()]));
+				controller.start();
+				const Chessboard &end =
+				    controller.get_chessboard();
+				const GameState state = end.get_game_state();
+				const int result =
+				    game_result(state, is_a_white);
+
+				lock_guard<mutex> lock(tally_mutex);
+				if (is_decided) return;
+				tally.wins += result > 0;
+				tally.draws += result == 0;
+				tally.losses += result < 0;
+				ratio = llr(tally, options.elo0, options.elo1);
+				is_decided = ratio <= lower || ratio >= upper;
+
+				cout << "game " << setw(5) << i + 1 << "  A "
+				     << (is_a_white ? "white " : "black ")
+				     << setw(7) << to_string(state) << "  +"
+				     << tally.wins << " =" << tally.draws
+				     << " -" << tally.losses << "  ";
+				print_elo(tally);
+				cout << "  llr " << setprecision(2) << ratio
+				     << " (" << lower << ", " << upper << ")"
+				     << setprecision(1) << endl;
+			});
+		}
+		pool.wait();
+	}
+	const chrono::duration<double> elapsed =
+	    chrono::steady_clock::now() - start;
+
+	for (int engine = 0; engine < 2; engine++) {
+		const Bot_params &params = options.engines[engine];
+		cout << (engine == 0 ? "A" : ", B") << ": depth "
+		     << params.depth << " mobility " << defaultfloat
+		     << params.mobility << fixed;
+	}
+	cout << endl;
+	cout << tally.games() << " games in " << elapsed.count() << " s ("
+	     << tally.games() / elapsed.count() * 3600 << " games/hour, "
+	     << options.threads << " workers), A scores +" << tally.wins
+	     << " =" << tally.draws << " -" << tally.losses << ", ";
+	if (tally.games() > 0) print_elo(tally);
+	cout << endl;
+	cout << "SPRT elo0 " << options.elo0 << " elo1 " << options.elo1
+	     << ": ";
+	if (ratio >= upper) {
+		cout << "H1 accepted, A is stronger" << endl;
+	} else if (ratio <= lower) {
+		cout << "H0 accepted, A isn't stronger" << endl;
+	} else {
+		cout << "inconclusive" << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "tools/pgn_check.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include "notation/pgn_reader.hpp"
+#include "utils/thread_pool.hpp"
+
+using namespace std;
+using namespace notation;
+
+struct Pgn_stats {
+	size_t games   = 0;
+	size_t moves   = 0;
+	size_t skipped = 0;
+	size_t invalid = 0;
+};
+
+struct Pgn_chunk {
+	const string *path;
+	string_view file;
+	string_view text;
+};
+
+static size_t line_number(string_view file, const char *position) {
+	const string_view before = file.substr(0, position - file.data());
+	return count(before.begin(), before.end(), '\n') + 1;
+}
+
+static void check_chunk(const Pgn_chunk &chunk, Pgn_stats &stats,
+			mutex &error_mutex) {
+	Pgn_reader reader(chunk.text);
+	Pgn_game game;
+	while (reader.next_game(game)) {
+		const Pgn_replay replay = replay_game(game);
+		stats.games++;
+		stats.moves += replay.moves;
+		if (replay.is_skipped) {
+			stats.skipped++;
+		} else if (!replay.is_valid) {
+			stats.invalid++;
+			const size_t line =
+			    line_number(chunk.file, replay.bad_move.data());
+			lock_guard<mutex> lock(error_mutex);
+			cerr << *chunk.path << ":" << line << ": rejected '"
+			     << replay.bad_move << "'" << endl;
+		}
+	}
+}
+
+int pgn_check(const vector<string> &paths, size_t threads) {
+	vector<unique_ptr<Mapped_file>> files;
+	vector<Pgn_chunk> chunks;
+	for (const auto &path : paths) {
+		files.push_back(make_unique<Mapped_file>(path));
+		const string_view file = files.back()->get_view();
+		for (const auto &text : split_games(file, threads)) {
+			chunks.push_back({&path, file, text});
+		}
+	}
+
+	vector<Pgn_stats> stats(chunks.size());
+	mutex error_mutex;
+
+	const auto start = chrono::steady_clock::now();
+	{
+		Thread_pool pool(threads);
+		for (size_t i = 0; i < chunks.size(); i++) {
+			pool.submit([&, i] {
+				check_chunk(chunks[i], stats[i], error_mutex);
+			});
+		}
+		pool.wait();
+	}
+	const chrono::duration<double> elapsed =
+	    chrono::steady_clock::now() - start;
+
+	Pgn_stats total;
+	for (const auto &stat : stats) {
+		total.games += stat.games;
+		total.moves += stat.moves;
+		total.skipped += stat.skipped;
+		total.invalid += stat.invalid;
+	}
+	const double seconds = max(elapsed.count(), 1e-9);
+
+	cout << "files: " << paths.size() << ", workers: " << threads << endl;
+	cout << "games: " << total.games << " (skipped: " << total.skipped
+	     << ", invalid: " << total.invalid << ")" << endl;
+	cout << "moves: " << total.moves << endl;
+	cout << "time: " << seconds << " s, " << total.games / seconds
+	     << " games/s, " << total.moves / seconds << " moves/s" << endl;
+
+	return total.invalid == 0 ? 0 : 1;
+}
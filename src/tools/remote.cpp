@@ -0,0 +1,349 @@
+#include "tools/remote.hpp"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "controller/game_scheduler.hpp"
+#include "net/remote_server.hpp"
+
+using namespace std;
+using namespace net;
+
+// pairs the players in the order they connect
+struct Lobby {
+	Game_scheduler &scheduler;
+	mutex waiting_mutex;
+	unique_ptr<Remote_player> waiting;
+	uint32_t games = 0;
+
+	explicit Lobby(Game_scheduler &scheduler) : scheduler(scheduler){};
+
+	void join(unique_ptr<Remote_player> player) {
+		lock_guard<mutex> lock(waiting_mutex);
+		if (!waiting) {
+			waiting = std::move(player);
+			return;
+		}
+		games++;
+		waiting->set_game(games);
+		player->set_game(games);
+		scheduler.add(make_unique<Controller>(std::move(waiting),
+						      std::move(player)));
+	};
+};
+
+static void print_stats(const Server_stats &stats) {
+	cout << stats.accepted << " connections (" << stats.connections
+	     << " open), " << stats.disconnected << " disconnected, "
+	     << stats.timeouts << " timeouts, " << stats.protocol_errors
+	     << " protocol errors, " << stats.resyncs << " resyncs" << endl;
+	cout << stats.frames_received << " frames in " << stats.reads
+	     << " reads (" << stats.bytes_received << " bytes), "
+	     << stats.frames_sent << " frames out in " << stats.writes
+	     << " writes (" << stats.bytes_sent << " bytes)" << endl;
+}
+
+int serve(uint16_t port, size_t threads, chrono::milliseconds timeout) {
+	raise_file_limit();
+	Game_scheduler scheduler(threads);
+	scheduler.set_on_finished([](size_t id, const Controller &controller) {
+		cout << "game " << id << " "
+		     << to_string(controller.get_chessboard().get_game_state())
+		     << endl;
+	});
+	Lobby lobby(scheduler);
+	unique_ptr<Remote_server> server;
+	try {
+		server = make_unique<Remote_server>(
+		    port, timeout, [&](unique_ptr<Remote_player> player) {
+			    lobby.join(std::move(player));
+		    });
+	} catch (const runtime_error &e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+	cout << "Listening on port " << server->get_port() << endl;
+	while (true) {
+		this_thread::sleep_for(chrono::seconds(10));
+		print_stats(server->get_stats());
+	}
+}
+
+struct Client {
+	enum Behaviour { HONEST, QUITTER, SILENT, FORGETFUL, NEWER };
+
+	int fd = -1;
+	Behaviour behaviour = HONEST;
+	uint32_t game       = 0;
+	Chessboard chessboard;
+	// bytes of an incomplete frame
+	vector<uint8_t> input;
+	int moves = 0;
+	// ply the server waits an answer for, during a resync
+	int pending = -1;
+};
+
+// clients that didn't get to the end of their game, or lost track of it
+struct Client_stats {
+	size_t stuck;
+	size_t desynchronized;
+};
+
+static bool connect_client(Client &client, uint16_t port) {
+	sockaddr_in address{};
+	address.sin_family      = AF_INET;
+	address.sin_port        = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	client.fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (client.fd < 0 ||
+	    connect(client.fd, (sockaddr *)&address, sizeof(address)) < 0) {
+		return false;
+	}
+	// the two halves of a frame are sent apart
+	const int no_delay = 1;
+	setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+		   sizeof(no_delay));
+	return true;
+}
+
+static bool send_frame(Client &client, const Frame &frame) {
+	vector<uint8_t> bytes;
+	encode(frame, bytes);
+	if (client.behaviour == Client::NEWER) {
+		// a version 2 frame, with a field the server doesn't know
+		const uint8_t field[] = {1, 2, 3, 4};
+		bytes.insert(bytes.end(), field, field + sizeof(field));
+		bytes[0] += sizeof(field);
+		bytes[2] = PROTOCOL_VERSION + 1;
+	}
+	const size_t half = bytes.size() / 2;
+	return ::send(client.fd, bytes.data(), half, MSG_NOSIGNAL) ==
+		   ssize_t(half) &&
+	       ::send(client.fd, &bytes[half], bytes.size() - half,
+		      MSG_NOSIGNAL) == ssize_t(bytes.size() - half);
+}
+
+// answer with a random legal move, false once the client left
+static bool answer(Client &client, minstd_rand &random) {
+	Chessboard &chessboard = client.chessboard;
+	if (++client.moves == 5) {
+		if (client.behaviour == Client::QUITTER) return false;
+		// the server closes the connection once the time is up
+		if (client.behaviour == Client::SILENT) return true;
+	}
+	const vector<board::Move> moves = chessboard.get_all_legal_moves();
+	Frame frame;
+	frame.type     = MOVE;
+	frame.game     = client.game;
+	frame.sequence = chessboard.get_turn_count();
+	frame.move     = moves[random() % moves.size()];
+	chessboard.make_move(frame.move);
+	return send_frame(client, frame);
+}
+
+// apply the move of a frame if it is the next one of the game
+static void catch_up(Client &client, const Frame &frame) {
+	Chessboard &chessboard = client.chessboard;
+	if (frame.sequence == chessboard.get_turn_count() + 1) {
+		chessboard.make_move(frame.move);
+	}
+}
+
+// false once the client is done
+static bool on_frame(Client &client, const Frame &frame, minstd_rand &random,
+		     Client_stats &stats) {
+	Chessboard &chessboard = client.chessboard;
+	switch (frame.type) {
+	case START:
+		client.game = frame.game;
+		return true;
+	case YOUR_TURN:
+		catch_up(client, frame);
+		if (client.behaviour == Client::FORGETFUL &&
+		    client.moves == 3) {
+			// start again from the first move
+			client.moves++;
+			client.chessboard = Chessboard();
+			client.pending    = frame.sequence;
+			Frame resync;
+			resync.type = RESYNC;
+			resync.game = client.game;
+			return send_frame(client, resync);
+		}
+		if (frame.sequence != chessboard.get_turn_count()) {
+			stats.desynchronized++;
+			return false;
+		}
+		return answer(client, random);
+	case HISTORY:
+		if (frame.sequence == chessboard.get_turn_count()) {
+			chessboard.make_move(frame.move);
+		}
+		if (client.pending != chessboard.get_turn_count()) {
+			return true;
+		}
+		client.pending = -1;
+		return answer(client, random);
+	case GAME_OVER:
+		catch_up(client, frame);
+		if (frame.sequence != chessboard.get_turn_count()) {
+			stats.desynchronized++;
+		}
+		return false;
+	default:
+		// the moves of the client are all legal
+		stats.desynchronized++;
+		return false;
+	}
+}
+
+// play until every connection is closed
+static Client_stats run_clients(uint16_t port, size_t count,
+				chrono::milliseconds timeout) {
+	vector<Client> clients(count);
+	const int epoll = epoll_create1(EPOLL_CLOEXEC);
+	size_t left     = 0;
+	for (size_t i = 0; i < count; i++) {
+		Client &client   = clients[i];
+		client.behaviour = i % 32 == 31   ? Client::QUITTER
+				   : i % 32 == 15 ? Client::SILENT
+				   : i % 32 == 7  ? Client::FORGETFUL
+				   : i % 32 == 23 ? Client::NEWER
+						  : Client::HONEST;
+		epoll_event event{EPOLLIN, {.u64 = i}};
+		if (!connect_client(client, port) ||
+		    epoll_ctl(epoll, EPOLL_CTL_ADD, client.fd, &event) < 0) {
+			// the clients already connected still play
+			cerr << "Can't connect client " << i << ": "
+			     << strerror(errno) << endl;
+			break;
+		}
+		left++;
+	}
+
+	Client_stats stats{0, 0};
+	minstd_rand random(42);
+	epoll_event events[256];
+	// nothing happening for that long means the games are stuck
+	const auto idle_limit = 10 * timeout;
+	auto last_event       = chrono::steady_clock::now();
+	while (left > 0) {
+		const int ready = epoll_wait(epoll, events, 256, 100);
+		if (ready > 0) {
+			last_event = chrono::steady_clock::now();
+		} else if (chrono::steady_clock::now() - last_event >
+			   idle_limit) {
+			break;
+		}
+		for (int i = 0; i < ready; i++) {
+			Client &client = clients[events[i].data.u64];
+			uint8_t buffer[256];
+			const ssize_t received = recv(
+			    client.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+			if (received < 0 && errno == EAGAIN) continue;
+			bool is_over = received <= 0;
+			if (!is_over) {
+				client.input.insert(client.input.end(), buffer,
+						    buffer + received);
+			}
+			size_t offset = 0;
+			Frame frame;
+			size_t consumed;
+			while (!is_over &&
+			       decode(client.input.data() + offset,
+				      client.input.size() - offset, frame,
+				      consumed) == DECODED) {
+				offset += consumed;
+				is_over =
+				    !on_frame(client, frame, random, stats);
+			}
+			client.input.erase(client.input.begin(),
+					   client.input.begin() + offset);
+			if (!is_over) continue;
+			epoll_ctl(epoll, EPOLL_CTL_DEL, client.fd, nullptr);
+			::close(client.fd);
+			client.fd = -1;
+			left--;
+		}
+	}
+	for (const Client &client : clients) {
+		if (client.fd >= 0) ::close(client.fd);
+	}
+	::close(epoll);
+	stats.stuck = left;
+	return stats;
+}
+
+int loopback(size_t clients, size_t threads, chrono::milliseconds timeout) {
+	clients += clients % 2;
+	// each client takes a descriptor on both sides of the connection
+	const size_t file_limit = raise_file_limit();
+	if (2 * clients + 64 > file_limit) {
+		cerr << "At most " << (file_limit - 64) / 2
+		     << " clients with the current limit of open files" << endl;
+		return 1;
+	}
+
+	size_t results[3] = {0, 0, 0};
+	const auto start  = chrono::steady_clock::now();
+	Game_scheduler scheduler(threads);
+	scheduler.set_on_finished([&](size_t, const Controller &controller) {
+		const GameState state =
+		    controller.get_chessboard().get_game_state();
+		results[state == WHITE_CHECKMATE   ? 0
+			: state == BLACK_CHECKMATE ? 2
+						   : 1]++;
+	});
+	Lobby lobby(scheduler);
+	Client_stats client_stats;
+	Server_stats stats;
+	try {
+		Remote_server server(
+		    0, timeout,
+		    [&](unique_ptr<Remote_player> player) {
+			    lobby.join(std::move(player));
+		    },
+		    "127.0.0.1");
+		client_stats =
+		    run_clients(server.get_port(), clients, timeout);
+		// the players still waiting resign once the time is up
+		scheduler.wait();
+		stats = server.get_stats();
+	} catch (const runtime_error &e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+	const chrono::duration<double> elapsed =
+	    chrono::steady_clock::now() - start;
+
+	const Scheduler_stats scheduler_stats = scheduler.get_stats();
+	cout << fixed << setprecision(3);
+	cout << clients << " clients played " << scheduler_stats.finished
+	     << " games in " << elapsed.count() << " s, white +" << results[0]
+	     << " =" << results[1] << " -" << results[2] << ", "
+	     << client_stats.stuck << " clients stuck, "
+	     << client_stats.desynchronized << " desynchronized" << endl;
+	print_stats(stats);
+	cout << "latency mean " << scheduler_stats.mean_latency_ms
+	     << " ms max " << scheduler_stats.max_latency_ms << " ms" << endl;
+	const bool is_valid = client_stats.stuck == 0 &&
+			      client_stats.desynchronized == 0 &&
+			      stats.protocol_errors == 0 &&
+			      scheduler_stats.finished == clients / 2;
+	return is_valid ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include "tools/replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "controller/controller.hpp"
+#include "player/player_tui.hpp"
+#include "utils/thread_pool.hpp"
+
+using namespace std;
+
+struct Replay_result {
+	bool is_passed = false;
+	string error;
+	chrono::duration<double, milli> elapsed;
+};
+
+static bool is_transcript(const filesystem::directory_entry &entry) {
+	const auto &file = entry.path();
+	return entry.is_regular_file() && file.extension() == ".txt" &&
+	       file.filename().string()[0] != '.';
+}
+
+static vector<string> list_transcripts(const vector<string> &paths) {
+	vector<string> transcripts;
+	for (const auto &path : paths) {
+		if (!filesystem::is_directory(path)) {
+			transcripts.push_back(path);
+			continue;
+		}
+		vector<string> found;
+		for (const auto &entry : filesystem::directory_iterator(path)) {
+			if (is_transcript(entry)) {
+				found.push_back(entry.path().string());
+			}
+		}
+		sort(found.begin(), found.end());
+		for (auto &transcript : found) {
+			transcripts.push_back(std::move(transcript));
+		}
+	}
+	return transcripts;
+}
+
+static void replay_transcript(const string &path, Replay_result &result) {
+	ifstream file(path);
+	if (!file) {
+		result.error = "can't open the transcript";
+		return;
+	}
+	// same input and reference as test-level.sh: grep -v '#' and tail -1
+	string input;
+	string line;
+	string last_line;
+	while (getline(file, line)) {
+		if (line.find('#') == string::npos) {
+			input += line;
+			input += '\n';
+		}
+		last_line = line;
+	}
+	istringstream expected(last_line);
+	string expected_position;
+	string expected_result;
+	expected >> expected_position >> expected_result;
+
+	istringstream in(input);
+	ostream null(nullptr);
+	Controller controller(make_unique<Player_tui>(in, null),
+			      make_unique<Player_tui>(in, null));
+	try {
+		controller.start();
+	} catch (const exception &e) {
+		result.error = string("exception: ") + e.what();
+		return;
+	}
+
+	const Chessboard &chessboard  = controller.get_chessboard();
+	const string position         = board::to_string(chessboard.to_array());
+	const string_view game_result = to_string(chessboard.get_game_state());
+	if (position != expected_position) {
+		result.error = "position differs, ref: " + expected_position +
+			       " got: " + position;
+	} else if (game_result != expected_result) {
+		result.error = "result differs, ref: " + expected_result +
+			       " got: " + string(game_result);
+	} else {
+		result.is_passed = true;
+	}
+}
+
+int replay(const vector<string> &paths, size_t threads) {
+	const vector<string> transcripts = list_transcripts(paths);
+	vector<Replay_result> results(transcripts.size());
+
+	const auto start = chrono::steady_clock::now();
+	{
+		Thread_pool pool(threads);
+		for (size_t i = 0; i < transcripts.size(); i++) {
+			pool.submit([&, i] {
+				const auto begin = chrono::steady_clock::now();
+				replay_transcript(transcripts[i], results[i]);
+				results[i].elapsed =
+				    chrono::steady_clock::now() - begin;
+			});
+		}
+		pool.wait();
+	}
+	const chrono::duration<double, milli> elapsed =
+	    chrono::steady_clock::now() - start;
+
+	size_t passed = 0;
+	chrono::duration<double, milli> total(0);
+	cout << fixed << setprecision(3);
+	for (size_t i = 0; i < transcripts.size(); i++) {
+		const Replay_result &result = results[i];
+		passed += result.is_passed;
+		total += result.elapsed;
+		cout << setw(10) << result.elapsed.count() << " ms  "
+		     << (result.is_passed ? "OK    " : "FAIL  ")
+		     << transcripts[i] << endl;
+		if (!result.is_passed) cout << "    " << result.error << endl;
+	}
+	cout << "passed " << passed << "/" << transcripts.size() << " in "
+	     << total.count() << " ms (wall " << elapsed.count() << " ms, "
+	     << threads << " workers)" << endl;
+
+	return passed == transcripts.size() ? 0 : 1;
+}
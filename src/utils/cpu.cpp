@@ -0,0 +1,27 @@
+#include "utils/cpu.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+static Cpu_features detect() {
+	__builtin_cpu_init();
+	Cpu_features features;
+	features.popcnt = __builtin_cpu_supports("popcnt");
+	features.bmi2   = __builtin_cpu_supports("bmi2");
+	features.avx2   = __builtin_cpu_supports("avx2");
+	return features;
+}
+#else
+static Cpu_features detect() { return Cpu_features(); }
+#endif
+
+const Cpu_features &cpu_features() {
+	static const Cpu_features features = detect();
+	return features;
+}
+
+std::string_view cpu_dispatch_level() {
+#ifdef CPU_DISPATCH_ENABLED
+	if (__builtin_cpu_supports("x86-64-v3")) return "x86-64-v3";
+	if (cpu_features().popcnt) return "popcnt";
+#endif
+	return "default";
+}
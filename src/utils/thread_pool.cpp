@@ -0,0 +1,67 @@
+#include "utils/thread_pool.hpp"
+
+size_t Thread_pool::default_size() {
+	const size_t count = std::thread::hardware_concurrency();
+	return count == 0 ? 1 : count;
+}
+
+Thread_pool::Thread_pool(size_t count) {
+	if (count == 0) count = 1;
+	workers.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		workers.emplace_back([this] { run(); });
+	}
+}
+
+Thread_pool::~Thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		is_stopped = true;
+	}
+	task_available.notify_all();
+	for (auto &worker : workers) worker.join();
+}
+
+void Thread_pool::submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	task_available.notify_one();
+}
+
+void Thread_pool::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	all_done.wait(lock, [this] { return tasks.empty() && active == 0; });
+	if (error) {
+		std::exception_ptr first = error;
+		error                    = nullptr;
+		std::rethrow_exception(first);
+	}
+}
+
+void Thread_pool::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		task_available.wait(
+		    lock, [this] { return is_stopped || !tasks.empty(); });
+		if (tasks.empty()) return;
+
+		std::function<void()> task = std::move(tasks.front());
+		tasks.pop_front();
+		active++;
+		lock.unlock();
+
+		try {
+			task();
+		} catch (...) {
+			lock.lock();
+			if (!error) error = std::current_exception();
+			lock.unlock();
+		}
+
+		lock.lock();
+		active--;
+		if (tasks.empty() && active == 0) all_done.notify_all();
+	}
+}
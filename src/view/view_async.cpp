@@ -0,0 +1,106 @@
+#include "view/view_async.hpp"
+
+View_async::View_async(std::unique_ptr<View> view, Policy policy,
+		       std::ostream &out)
+    : view(std::move(view)), policy(policy), out(out) {
+	renderer = std::thread([this] { render(); });
+}
+
+View_async::~View_async() {
+	is_stopped = true;
+	published++;
+	published.notify_one();
+	renderer.join();
+}
+
+void View_async::push(const Event &event) {
+	while (!events.try_push(event)) {
+		// the renderer is a whole queue behind, wait for it to take one
+		const uint32_t seen = consumed;
+		if (events.try_push(event)) break;
+		consumed.wait(seen);
+	}
+	published++;
+	published.notify_one();
+}
+
+int View_async::Log_buffer::sync() {
+	if (str().empty()) return 0;
+	owner.push({Event::LOG, ++owner.sequence, {}, {}, str()});
+	str("");
+	return 0;
+}
+
+void View_async::start_new_game(const Chessboard &chessboard) {
+	push({Event::START, ++sequence, {}, chessboard});
+}
+
+void View_async::update(const Move_event &event,
+			const Chessboard &chessboard) {
+	if (policy == BACKPRESSURE) {
+		push({Event::UPDATE, ++sequence, event, chessboard});
+		return;
+	}
+	// kept to be sure the final position is rendered before the end
+	last_update = {Event::UPDATE, ++sequence, event, chessboard};
+	latest[back] = last_update;
+	const uint8_t previous = middle.exchange(back | FRESH);
+	back                   = previous & ~FRESH;
+	if (previous & FRESH) dropped++;
+	published++;
+	published.notify_one();
+}
+
+void View_async::end(const Chessboard &chessboard) {
+	// the renderer skips it if it already took it from the triple buffer
+	if (policy == DROP_TO_LATEST && last_update.sequence > 0) {
+		push(last_update);
+	}
+	push({Event::END, ++sequence, {}, chessboard});
+}
+
+void View_async::render(const Event &event, uint64_t &rendered) {
+	if (event.sequence <= rendered) return;
+	rendered = event.sequence;
+	if (event.type == Event::START) {
+		view->start_new_game(event.chessboard);
+	} else if (event.type == Event::UPDATE) {
+		view->update(event.move, event.chessboard);
+	} else if (event.type == Event::END) {
+		view->end(event.chessboard);
+	} else {
+		out << event.text << std::flush;
+	}
+}
+
+// renderer thread, the events are rendered in the order of their sequence
+void View_async::render() {
+	uint64_t rendered = 0;
+	bool is_holding   = false;
+	while (true) {
+		const uint32_t seen = published;
+		// the queue is read first: an update published before its front
+		// event is then already in the triple buffer, and can't be
+		// taken after that event was rendered
+		Event *next = events.front();
+		if (!is_holding && (middle & FRESH)) {
+			front      = middle.exchange(front) & ~FRESH;
+			is_holding = true;
+		}
+		if (is_holding &&
+		    (!next || latest[front].sequence < next->sequence)) {
+			render(latest[front], rendered);
+			is_holding = false;
+			continue;
+		}
+		if (next) {
+			render(*next, rendered);
+			events.pop();
+			consumed++;
+			consumed.notify_one();
+			continue;
+		}
+		if (is_stopped) return;
+		published.wait(seen);
+	}
+}
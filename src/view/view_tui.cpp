@@ -1,8 +1,6 @@
 #include "view/view_tui.hpp"
 
-#include <cassert>
-#include <iostream>
-#include <stdexcept>
+#include <cstdlib>
 #include <string>
 
 #include "logic/chessboard.hpp"
@@ -14,50 +12,135 @@ static const constexpr char bright_bg[] = "\033[47m";
 static const constexpr char dark_bg[]   = "\033[40m";
 static const constexpr char reset_bg[]  = "\033[49m";
 
-std::string to_string(GameState state) {
-	switch (state) {
-	case ONGOING:
-		return "?-?";
-	case WHITE_CHECKMATE:
-		return "1-0";
-	case BLACK_CHECKMATE:
-		return "0-1";
-	case STALEMATE:
-		return "1/2-1/2";
-	default:
-		throw std::invalid_argument("Incorrect GameState");
-	}
+// clear the terminal and move to its first line
+static const constexpr char clear_screen[]   = "\033[2J\033[H";
+static const constexpr char save_cursor[]    = "\0337";
+static const constexpr char restore_cursor[] = "\0338";
+
+// the header and the 8 lines of the board, then an empty line
+static const constexpr int board_height = 10;
+
+View_tui::View_tui(Mode mode, std::ostream &out) : mode(mode), out(out) {
+	// a whole board with its colors is about 700 bytes
+	frame.reserve(2048);
+}
+
+static void append_number(string &frame, int number) {
+	if (number >= 10) frame += char('0' + number / 10);
+	frame += char('0' + number % 10);
 }
 
-void View_tui::start_new_game(Chessboard chessboard) { update(chessboard); }
-
-void View_tui::update(Chessboard chessboard) {
-	const Board board = chessboard.to_array();
-	cout << reset_bg << " ABCDEFGH" << endl;
-	char line = '8';
-	int count = 0;
-	for (auto rit = board.crbegin(); rit != board.rend(); ++rit) {
-		count++;
-		cout << line;
-		line--;
-		for (auto piece : *rit) {
-			count++;
-			cout << (count % 2 ? bright_bg : dark_bg)
-			     << piece.to_utf();
+void View_tui::draw_square(int line, int col, Colored_piece piece) {
+	frame += (line + col) % 2 ? dark_bg : bright_bg;
+	frame += piece.to_utf_cstr();
+}
+
+void View_tui::draw_board(const Board &board) {
+	frame += reset_bg;
+	frame += " ABCDEFGH\n";
+	for (int line = LINE_8; line >= LINE_1; line--) {
+		frame += char('1' + line);
+		for (int col = COL_A; col <= COL_H; col++) {
+			draw_square(line, col, board[line][col]);
 		}
-		cout << reset_bg << endl;
+		frame += reset_bg;
+		frame += '\n';
 	}
+}
 
-	this->chessboard = std::move(chessboard);
+void View_tui::write() {
+	out.write(frame.data(), frame.size());
+	out.flush();
+	frame.clear();
 }
 
-void View_tui::end() {
-	const Board board = chessboard.to_array();
-	cout << endl;
-	for (auto& line : board) {
-		for (auto& square : line) {
-			cout << square.to_string() << ',';
+void View_tui::start_new_game(const Chessboard &chessboard) {
+	if (mode == SCROLL) {
+		update({}, chessboard);
+		return;
+	}
+	screen = chessboard.to_array();
+	ply    = chessboard.get_turn_count();
+	frame += clear_screen;
+	draw_board(screen);
+	// keep the board on the screen, the lines below it scroll alone
+	frame += "\n\033[";
+	append_number(frame, board_height + 1);
+	frame += "r\033[";
+	append_number(frame, board_height + 1);
+	frame += ";1H";
+	write();
+}
+
+void View_tui::redraw(const Chessboard &chessboard, Square square) {
+	const Colored_piece piece = chessboard.get_piece(square);
+	Colored_piece &shown      = screen[square.line][square.col];
+	if (piece.piece == shown.piece && piece.color == shown.color) return;
+	shown = piece;
+	if (frame.empty()) frame += save_cursor;
+	// the first line of the terminal is the header
+	frame += "\033[";
+	append_number(frame, 2 + LINE_8 - square.line);
+	frame += ';';
+	append_number(frame, 2 + square.col);
+	frame += 'H';
+	draw_square(square.line, square.col, piece);
+}
+
+void View_tui::update(const Move_event &event, const Chessboard &chessboard) {
+	if (mode == SCROLL) {
+		draw_board(chessboard.to_array());
+		write();
+		return;
+	}
+	const int previous = ply;
+	ply                = chessboard.get_turn_count();
+	if (ply != previous + 1) {
+		// an update was skipped, any square may have changed
+		for (int line = LINE_1; line <= LINE_8; line++) {
+			for (int col = COL_A; col <= COL_H; col++) {
+				redraw(chessboard,
+				       Square(Line(line), Column(col)));
+			}
+		}
+	} else {
+		// only the squares of the move change
+		const Square from = event.move.from;
+		const Square to   = event.move.to;
+		const bool is_en_passant =
+		    event.captured.piece == PAWN &&
+		    screen[to.line][to.col].piece == NO_PIECE;
+		redraw(chessboard, from);
+		redraw(chessboard, to);
+		if (is_en_passant) {
+			redraw(chessboard, Square(from.line, to.col));
 		}
+		if (chessboard.get_piece(to).piece == KING &&
+		    abs(to.col - from.col) == 2) {
+			const bool is_kingside = to.col > from.col;
+			redraw(chessboard,
+			       Square(from.line, is_kingside ? COL_H : COL_A));
+			redraw(chessboard,
+			       Square(from.line, is_kingside ? COL_F : COL_D));
+		}
+	}
+	if (frame.empty()) return;
+	// the colors are restored along with the cursor
+	frame += restore_cursor;
+	write();
+}
+
+void View_tui::end(const Chessboard &chessboard) {
+	if (mode == DIFF) {
+		// setting the scrolling region moves the cursor
+		frame += save_cursor;
+		frame += "\033[r";
+		frame += restore_cursor;
 	}
-	cout << " " << to_string(chessboard.get_game_state()) << endl;
+	frame += '\n';
+	frame += board::to_string(chessboard.to_array());
+	frame += ' ';
+	frame += to_string(chessboard.get_game_state());
+	frame += '\n';
+	write();
 }
@@ -0,0 +1,166 @@
+#!/bin/bash
+
+# check the output of a game rendered by the view of the terminal
+# async: the bot's log lines stay in order with the boards around them
+# diff: the board is drawn once, then the squares of each move are redrawn
+# in place, and replaying the output on a screen gives the final position
+
+if [ $# -ne 2 ]; then
+	echo "usage: $0 async|diff prog"
+	exit 1
+fi
+mode=$1
+CHESS_PROG="$2"
+
+if ! [ -x "$CHESS_PROG" ]; then
+	echo "* Error: $CHESS_PROG is not executable."
+	exit 1
+fi
+
+# the pieces as letters, uppercase for white, and the squares as dots
+to_letters() {
+	sed -e 's/\xe2\x99\x9a/K/g' -e 's/\xe2\x99\x9b/Q/g' \
+	    -e 's/\xe2\x99\x9c/R/g' -e 's/\xe2\x99\x9d/B/g' \
+	    -e 's/\xe2\x99\x9e/N/g' -e 's/\xe2\x99\x9f/P/g' \
+	    -e 's/\xe2\x99\x94/k/g' -e 's/\xe2\x99\x95/q/g' \
+	    -e 's/\xe2\x99\x96/r/g' -e 's/\xe2\x99\x97/b/g' \
+	    -e 's/\xe2\x99\x98/n/g' -e 's/\xe2\x99\x99/p/g' \
+	    -e 's/\x1b\[4[07]m /./g'
+}
+
+case $mode in
+async)
+	# The bot plays white and logs "from to" before its move. A board
+	# printed before that line still has the white piece on "from", one
+	# printed after it, and before the next line, no longer has it.
+	"$CHESS_PROG" -w bot -b random | to_letters |
+	    sed -e 's/\x1b\[[0-9;]*[A-Za-z]//g' | LC_ALL=C awk '
+		function square(s) {
+			return board[9 - substr(s, 2, 1), \
+				     index("abcdefgh", substr(s, 1, 1))]
+		}
+		function check(  piece) {
+			if (from == "") return
+			piece = square(from)
+			if ((piece ~ /[KQRBNP]/) != !is_after) {
+				print "board " boards " is out of order with \"" \
+				      move "\""
+				failed = 1
+			}
+		}
+		/^ ABCDEFGH$/ { row = 0; next }
+		/^[1-8]/ && row < 8 {
+			row++
+			for (i = 1; i <= 8; i++) {
+				board[row, i] = substr($0, i + 1, 1)
+			}
+			if (row < 8) next
+			boards++
+			check()
+			has_board = 1
+			next
+		}
+		/^[a-h][1-8] [a-h][1-8]$/ {
+			move     = $0
+			from     = $1
+			is_after = 0
+			# the last board printed before the move
+			if (has_board) check()
+			is_after  = 1
+			has_board = 0
+			moves++
+		}
+		END {
+			if (!moves || !boards) {
+				print "no move or no board"
+				exit 1
+			}
+			exit failed
+		}'
+	;;
+diff)
+	# the bot paces the game so that most moves are drawn, not dropped
+	out=$("$CHESS_PROG" -w bot -b random -r diff | to_letters)
+	# the final position, from a1 to h8, is on the last line
+	position=$(echo "$out" | tail -1 | cut -f1 -d' ')
+	# each record starts after an escape character, with its sequence
+	echo "$out" | LC_ALL=C awk -v position="$position" '
+		BEGIN { RS = "\033"; row = 1; col = 1 }
+		/^\[[0-9;]*[A-Za-z]/ {
+			match($0, /^\[[0-9;]*[A-Za-z]/)
+			sequence = substr($0, 2, RLENGTH - 2)
+			command  = substr($0, RLENGTH, 1)
+			text     = substr($0, RLENGTH + 1)
+			if (command == "H") {
+				n   = split(sequence, at, ";")
+				row = n >= 1 ? at[1] : 1
+				col = n >= 2 ? at[2] : 1
+				if (row >= 2 && row <= 9) moves++
+			} else if (command == "r") {
+				row = 1
+				col = 1
+			}
+			write(text)
+			next
+		}
+		/^7/ {
+			saved_row = row
+			saved_col = col
+			write(substr($0, 2))
+			next
+		}
+		/^8/ {
+			row = saved_row
+			col = saved_col
+			write(substr($0, 2))
+			next
+		}
+		{ write($0) }
+		function write(text,  i, c) {
+			if (text ~ /ABCDEFGH/) boards++
+			for (i = 1; i <= length(text); i++) {
+				c = substr(text, i, 1)
+				if (c == "\n") {
+					row++
+					col = 1
+				} else {
+					screen[row, col++] = c
+				}
+			}
+		}
+		END {
+			if (boards != 1) {
+				print boards " boards drawn instead of 1"
+				exit 1
+			}
+			if (!moves) {
+				print "no square redrawn in place"
+				exit 1
+			}
+			split(position, pieces, ",")
+			for (i = 1; i <= 64; i++) {
+				line   = int((i - 1) / 8) + 1
+				column = (i - 1) % 8 + 1
+				piece  = pieces[i]
+				if (piece == "") {
+					piece = "."
+				} else if (piece ~ /^w/) {
+					piece = substr(piece, 2)
+				} else {
+					piece = tolower(substr(piece, 2))
+				}
+				# the header is on the first line of the screen
+				if (screen[10 - line, column + 1] != piece) {
+					print "square " i " is \"" \
+					      screen[10 - line, column + 1] \
+					      "\" instead of \"" piece "\""
+					exit 1
+				}
+			}
+		}'
+	;;
+*)
+	echo "* Unknown mode $mode"
+	exit 1
+	;;
+esac